@@ -220,6 +220,15 @@ namespace ox {
             return down(std::optional(curr));
         }
 
+        // Flat-index neighbours in up, left, down, right order; -1 marks an out-of-bounds neighbour
+        [[nodiscard]] std::array<long, 4> cardinal_neighbour_indices(long index) const {
+            long width = long(get_width());
+            return {index >= width ? index - width : -1,
+                    index % width != 0 ? index - 1 : -1,
+                    index + width < long(data.size()) ? index + width : -1,
+                    (index + 1) % width != 0 ? index + 1 : -1};
+        }
+
 #ifndef __cpp_lib_ranges_cartesian_product
         auto neighbour_range(raw_iterator current) {
             std::array neighbours{up(std::optional(current)),
@@ -0,0 +1,203 @@
+#ifndef OXLIB__EYTZINGER_TREE_H
+#define OXLIB__EYTZINGER_TREE_H
+
+#include <vector>
+#include <bit>
+#include <iterator>
+#include <functional>
+#include <ranges>
+#include <algorithm>
+#include "_binary_tree.h"
+
+namespace ox {
+    /*
+     * Read-only binary search tree frozen into Eytzinger (breadth-first) order.
+     * The node at slot k has its children at 2k and 2k + 1, so a search walks one contiguous array with
+     * no pointers, a branch-free step per level and the next levels prefetched ahead of the comparison.
+     *
+     * Freezing a binary_tree keeps its in-order sequence, which must be sorted by Compare.
+     * Iteration is in-order and, like binary_tree::iterator, yields nodes with a value member.
+     */
+    template <typename Value, typename Compare = std::less<>>
+    class eytzinger_tree {
+    public:
+        class iterator;
+        using const_iterator = iterator;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using value_type = Value;
+        using size_type = std::size_t;
+
+        struct node {
+            Value value;
+        };
+    private:
+        // slot 0 is unused so the children of k are always 2k and 2k + 1
+        std::vector<node> nodes;
+        Compare cmp;
+
+        constexpr static size_type prefetch_stride = std::max<size_type>(1, 64 / sizeof(node));
+
+        template <std::input_iterator I>
+        void fill(I& in, size_type k) {
+            if (k >= nodes.size())
+                return;
+            fill(in, 2 * k);
+            nodes[k].value = *in++;
+            fill(in, 2 * k + 1);
+        }
+
+        static void collect_in_order(const binary_tree_node<Value>& source, std::vector<Value>& out) {
+            if (source.children.first)
+                collect_in_order(*source.children.first, out);
+            out.push_back(source.value);
+            if (source.children.second)
+                collect_in_order(*source.children.second, out);
+        }
+
+        // First slot whose value is not less than key, 0 if there is none
+        template <typename Key>
+        [[nodiscard]] size_type lower_bound_slot(const Key& key) const {
+            const node* base = nodes.data();
+            size_type n = size();
+            size_type k = 1;
+            while (k <= n) {
+#if defined(__GNUC__) || defined(__clang__)
+                __builtin_prefetch(base + k * prefetch_stride);
+#endif
+                k = 2 * k + size_type(std::invoke(cmp, base[k].value, key));
+            }
+            return k >> (std::countr_one(k) + 1);
+        }
+    public:
+        eytzinger_tree() : nodes(1) {}
+
+        // Builds from a range already sorted by cmp
+        template <std::ranges::input_range R>
+        requires std::convertible_to<std::ranges::range_reference_t<R>, Value>
+        explicit eytzinger_tree(R&& sorted, Compare _cmp = Compare()) : cmp(std::move(_cmp)) {
+            std::vector<Value> values(std::ranges::begin(sorted), std::ranges::end(sorted));
+            nodes.resize(values.size() + 1);
+            auto head = values.begin();
+            fill(head, 1);
+        }
+
+        explicit eytzinger_tree(const binary_tree_node<Value>& tree, Compare _cmp = Compare()) : cmp(std::move(_cmp)) {
+            std::vector<Value> values;
+            collect_in_order(tree, values);
+            nodes.resize(values.size() + 1);
+            auto head = values.begin();
+            fill(head, 1);
+        }
+
+        explicit eytzinger_tree(const binary_tree<Value>& tree, Compare _cmp = Compare()) :
+                eytzinger_tree(tree.head, std::move(_cmp)) {}
+
+        [[nodiscard]] size_type size() const { return nodes.size() - 1; }
+
+        [[nodiscard]] bool empty() const { return size() == 0; }
+
+        template <typename Key>
+        [[nodiscard]] iterator lower_bound(const Key& key) const {
+            return iterator(*this, lower_bound_slot(key));
+        }
+
+        template <typename Key>
+        [[nodiscard]] iterator find(const Key& key) const {
+            size_type k = lower_bound_slot(key);
+            if (k == 0 || std::invoke(cmp, key, nodes[k].value))
+                return end();
+            return iterator(*this, k);
+        }
+
+        template <typename Key>
+        [[nodiscard]] bool contains(const Key& key) const {
+            return find(key) != end();
+        }
+
+        // Slot array in Eytzinger order, starting at slot 1
+        [[nodiscard]] const std::vector<node>& get_raw() const { return nodes; }
+
+        iterator begin() const {
+            size_type k = empty() ? 0 : 1;
+            while (k && 2 * k <= size())
+                k *= 2;
+            return iterator(*this, k);
+        }
+        iterator end() const { return iterator(*this, 0); }
+
+        reverse_iterator rbegin() const { return reverse_iterator(end()); }
+        reverse_iterator rend() const { return reverse_iterator(begin()); }
+    };
+
+    template <typename Value, typename Compare>
+    class eytzinger_tree<Value, Compare>::iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = eytzinger_tree::node;
+        using difference_type = int;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+        using const_pointer = const value_type*;
+        using const_reference = const value_type&;
+    private:
+        using self = eytzinger_tree<Value, Compare>::iterator;
+        const eytzinger_tree* tree = nullptr;
+        size_type slot = 0;
+    public:
+        iterator() = default;
+
+        iterator(const eytzinger_tree& source, size_type _slot) : tree(&source), slot(_slot) {}
+
+        reference operator*() const { return tree->nodes[slot]; }
+
+        const_pointer operator->() const { return &tree->nodes[slot]; }
+
+        // Position in the Eytzinger array, 0 for end
+        [[nodiscard]] size_type get_slot() const { return slot; }
+
+        self& operator++() {
+            size_type n = tree->size();
+            if (2 * slot + 1 <= n) {
+                slot = 2 * slot + 1;
+                while (2 * slot <= n)
+                    slot *= 2;
+            } else {
+                // climb while this is a right child, then once more
+                slot >>= std::countr_one(slot) + 1;
+            }
+            return *this;
+        }
+
+        self operator++(int) {
+            auto cpy(*this);
+            ++(*this);
+            return cpy;
+        }
+
+        self& operator--() {
+            size_type n = tree->size();
+            if (slot == 0) {
+                slot = 1;
+                while (2 * slot + 1 <= n)
+                    slot = 2 * slot + 1;
+            } else if (2 * slot <= n) {
+                slot *= 2;
+                while (2 * slot + 1 <= n)
+                    slot = 2 * slot + 1;
+            } else {
+                slot >>= std::countr_zero(slot) + 1;
+            }
+            return *this;
+        }
+
+        self operator--(int) {
+            auto cpy(*this);
+            --(*this);
+            return cpy;
+        }
+
+        bool operator==(const self& other) const { return slot == other.slot; }
+    };
+} // namespace ox
+
+#endif // OXLIB__EYTZINGER_TREE_H
@@ -0,0 +1,229 @@
+#ifndef OXLIB__GEMM_H
+#define OXLIB__GEMM_H
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "multithreading/parallel_for.h"
+
+namespace ox {
+    /*
+     * Non-owning view of a rows x cols block of elements, element (r, c) living at
+     * data[r * row_stride + c * col_stride]. Swapping the strides transposes it without touching the storage.
+     */
+    template <typename T>
+    struct strided_block {
+        T* data = nullptr;
+        std::size_t rows = 0;
+        std::size_t cols = 0;
+        std::ptrdiff_t row_stride = 0;
+        std::ptrdiff_t col_stride = 1;
+
+        [[nodiscard]] T& operator()(std::size_t r, std::size_t c) const {
+            return data[std::ptrdiff_t(r) * row_stride + std::ptrdiff_t(c) * col_stride];
+        }
+
+        [[nodiscard]] strided_block sub(std::size_t r, std::size_t c, std::size_t n_rows, std::size_t n_cols) const {
+            return {&(*this)(r, c), n_rows, n_cols, row_stride, col_stride};
+        }
+
+        [[nodiscard]] strided_block transposed() const { return {data, cols, rows, col_stride, row_stride}; }
+
+        operator strided_block<const T>() const
+        requires(!std::is_const_v<T>)
+        {
+            return {data, rows, cols, row_stride, col_stride};
+        }
+    };
+
+    namespace details {
+        template <typename T>
+        concept simd_element =
+                std::is_arithmetic_v<T> && !std::is_same_v<T, bool> && (sizeof(T) == 4 || sizeof(T) == 8);
+
+        template <typename T>
+        struct simd_vector_of {
+            typedef T type __attribute__((vector_size(32)));
+        };
+        template <typename T>
+        using simd_vector = typename simd_vector_of<T>::type;
+
+        // Largest scratch buffer a thread keeps between calls, for each element type and Tag
+        inline constexpr std::size_t scratch_retained_bytes = std::size_t(4) << 20;
+
+        // A buffer handed out by scratch_buffer: the thread's kept one, or one of its own that goes with the handle
+        template <typename T>
+        class scratch {
+            std::unique_ptr<T[]> owned;
+            T* pointer;
+        public:
+            explicit scratch(T* kept) : pointer(kept) {}
+            explicit scratch(std::unique_ptr<T[]> _owned) : owned(std::move(_owned)), pointer(owned.get()) {}
+
+            [[nodiscard]] T* get() const { return pointer; }
+        };
+
+        /*
+         * Per thread buffer of at least n elements, reused across calls so repeated products do not allocate.
+         * Tag separates buffers of the same type that are live at the same time. Requests above
+         * scratch_retained_bytes are allocated for the call only, so no thread keeps its largest matrix alive.
+         */
+        template <typename T, int Tag>
+        scratch<T> scratch_buffer(std::size_t n) {
+            if (n > scratch_retained_bytes / sizeof(T))
+                return scratch<T>(std::unique_ptr<T[]>(new T[n]));
+            thread_local std::unique_ptr<T[]> buffer;
+            thread_local std::size_t capacity = 0;
+            if (capacity < n) {
+                buffer.reset(new T[n]);
+                capacity = n;
+            }
+            return scratch<T>(buffer.get());
+        }
+
+        template <typename T>
+        struct gemm_blocking {
+            // micro tile of mr rows by one vector of nr columns, kept in registers
+            static constexpr std::size_t nr = 32 / sizeof(T);
+            static constexpr std::size_t mr = 6;
+            // packed a block of mc x kc stays in L2, packed b panel of kc x nc in L3
+            static constexpr std::size_t kc = 256;
+            static constexpr std::size_t mc = 16 * mr;
+            static constexpr std::size_t nc = 128 * nr;
+        };
+
+        // a as consecutive panels of mr rows, each stored column by column and padded with zeros
+        template <typename T>
+        void pack_lhs(strided_block<const T> a, T* out) {
+            constexpr std::size_t mr = gemm_blocking<T>::mr;
+            for (std::size_t r = 0; r < a.rows; r += mr) {
+                std::size_t rows = std::min(mr, a.rows - r);
+                for (std::size_t k = 0; k < a.cols; ++k) {
+                    for (std::size_t i = 0; i < rows; ++i)
+                        out[i] = a(r + i, k);
+                    for (std::size_t i = rows; i < mr; ++i)
+                        out[i] = T{};
+                    out += mr;
+                }
+            }
+        }
+
+        // b as consecutive panels of nr columns, each stored as one vector per row
+        template <typename T>
+        void pack_rhs(strided_block<const T> b, simd_vector<T>* out) {
+            constexpr std::size_t nr = gemm_blocking<T>::nr;
+            for (std::size_t c = 0; c < b.cols; c += nr) {
+                std::size_t cols = std::min(nr, b.cols - c);
+                for (std::size_t k = 0; k < b.rows; ++k) {
+                    simd_vector<T> v{};
+                    for (std::size_t j = 0; j < cols; ++j)
+                        v[j] = b(k, c + j);
+                    *out++ = v;
+                }
+            }
+        }
+
+        template <typename T>
+        void micro_kernel(std::size_t kc, const T* a, const simd_vector<T>* b, T* c, std::size_t ldc, std::size_t rows,
+                          std::size_t cols) {
+            constexpr std::size_t mr = gemm_blocking<T>::mr;
+            simd_vector<T> acc[mr] = {};
+            for (std::size_t k = 0; k < kc; ++k, a += mr) {
+                simd_vector<T> bk = b[k];
+                for (std::size_t i = 0; i < mr; ++i)
+                    acc[i] += a[i] * bk;
+            }
+            for (std::size_t i = 0; i < rows; ++i)
+                for (std::size_t j = 0; j < cols; ++j)
+                    c[i * ldc + j] += acc[i][j];
+        }
+
+        // c = a * b with packed operands, blocked for the cache hierarchy
+        template <simd_element T>
+        void gemm(strided_block<const T> a, strided_block<const T> b, T* c, std::size_t ldc) {
+            using blocking = gemm_blocking<T>;
+            constexpr std::size_t mr = blocking::mr, nr = blocking::nr;
+            for (std::size_t i = 0; i < a.rows; ++i)
+                std::fill_n(c + i * ldc, b.cols, T{});
+
+            scratch<T> a_buffer = scratch_buffer<T, 0>(blocking::mc * blocking::kc);
+            scratch<simd_vector<T>> b_buffer = scratch_buffer<simd_vector<T>, 0>(blocking::kc * (blocking::nc / nr));
+            T* packed_a = a_buffer.get();
+            simd_vector<T>* packed_b = b_buffer.get();
+            for (std::size_t jc = 0; jc < b.cols; jc += blocking::nc) {
+                std::size_t nc = std::min(blocking::nc, b.cols - jc);
+                for (std::size_t pc = 0; pc < a.cols; pc += blocking::kc) {
+                    std::size_t kc = std::min(blocking::kc, a.cols - pc);
+                    pack_rhs(b.sub(pc, jc, kc, nc), packed_b);
+                    for (std::size_t ic = 0; ic < a.rows; ic += blocking::mc) {
+                        std::size_t mc = std::min(blocking::mc, a.rows - ic);
+                        pack_lhs(a.sub(ic, pc, mc, kc), packed_a);
+                        for (std::size_t jr = 0; jr < nc; jr += nr) {
+                            for (std::size_t ir = 0; ir < mc; ir += mr) {
+                                micro_kernel(kc,
+                                             packed_a + ir * kc,
+                                             packed_b + jr / nr * kc,
+                                             c + (ic + ir) * ldc + jc + jr,
+                                             ldc,
+                                             std::min(mr, mc - ir),
+                                             std::min(nr, nc - jr));
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        // For element types without vector arithmetic (ox::modulo, ox::rational, ...): b is transposed once so
+        // every inner product runs over two contiguous rows
+        template <typename T>
+        void gemm(strided_block<const T> a, strided_block<const T> b, T* c, std::size_t ldc) {
+            constexpr std::size_t column_block = 64;
+            scratch<T> bt_buffer = scratch_buffer<T, 0>(b.rows * b.cols);
+            T* bt = bt_buffer.get();
+            for (std::size_t k = 0; k < b.rows; ++k)
+                for (std::size_t j = 0; j < b.cols; ++j)
+                    bt[j * b.rows + k] = b(k, j);
+            scratch<T> row_buffer = scratch_buffer<T, 1>(a.col_stride == 1 ? 0 : a.cols);
+            T* row = row_buffer.get();
+
+            for (std::size_t jb = 0; jb < b.cols; jb += column_block) {
+                std::size_t j_end = std::min(b.cols, jb + column_block);
+                for (std::size_t i = 0; i < a.rows; ++i) {
+                    const T* lhs = &a(i, 0);
+                    if (a.col_stride != 1) {
+                        for (std::size_t k = 0; k < a.cols; ++k)
+                            row[k] = a(i, k);
+                        lhs = row;
+                    }
+                    for (std::size_t j = jb; j < j_end; ++j) {
+                        const T* rhs = bt + j * b.rows;
+                        T sum{};
+                        for (std::size_t k = 0; k < a.cols; ++k)
+                            sum += lhs[k] * rhs[k];
+                        c[i * ldc + j] = sum;
+                    }
+                }
+            }
+        }
+
+        // Splits the rows of c into slices computed on the pool and on the calling thread
+        template <typename T>
+        void gemm(strided_block<const T> a, strided_block<const T> b, T* c, std::size_t ldc,
+                  thread_pool<std::function<void()>>& pool) {
+            std::size_t tasks = std::max(1u, std::thread::hardware_concurrency());
+            std::size_t step = std::max<std::size_t>(gemm_blocking<T>::mr, (a.rows + tasks - 1) / tasks);
+            parallel_for(pool, (a.rows + step - 1) / step, [&](std::size_t slice) {
+                std::size_t r = slice * step;
+                gemm(a.sub(r, 0, std::min(step, a.rows - r), a.cols), b, c + r * ldc, ldc);
+            });
+        }
+    } // namespace details
+} // namespace ox
+
+#endif // OXLIB__GEMM_H
@@ -2,6 +2,9 @@
 #define OXLIB__MATRIX_H
 
 #include "_2d_grid.h"
+#include "_gemm.h"
+#include "_matrix_expression.h"
+#include "_matrix_view.h"
 #include <ox/math.h>
 #include <ranges>
 #include <exception>
@@ -10,102 +13,87 @@
 #include <concepts>
 
 namespace ox {
-
     template <typename T, typename Container>
-    class matrix;
-
-    struct invalid_matrix_dimensions : public std::exception {
-        char message[120]{};
-
-        invalid_matrix_dimensions(const auto& a, const auto& b, char op) {
-            snprintf(message,
-                     100,
-                     "Invalid dimensions: %zu x %zu and %zu x %zu for operator %c",
-                     a.get_width(),
-                     a.get_height(),
-                     b.get_width(),
-                     b.get_height(),
-                     op);
-        }
-
-        invalid_matrix_dimensions(const auto& a, const auto& b, const auto& dest, char op) {
-            snprintf(message,
-                     100,
-                     "Invalid dimensions: %zu x %zu and %zu x %zu for operator %c to %zu x %zu",
-                     a.get_width(),
-                     a.get_height(),
-                     b.get_width(),
-                     b.get_height(),
-                     op,
-                     dest.get_width(),
-                     dest.get_height());
-        }
-
-        [[nodiscard]] const char* what() const noexcept override { return message; }
-    };
-
-    template <typename T, typename Container = std::vector<T>>
     class matrix : public grid<T, Container> {
         using grid<T, Container>::grid;
 
-        static auto get_multiplication_stream(const matrix& lhs, const matrix& rhs) {
-            return std::views::iota(std::size_t(0), rhs.get_width() * lhs.get_height())
-                 | std::views::transform([&](std::size_t index) {
-                       std::pair coord = std::make_pair(index % rhs.get_width(), index / rhs.get_width());
-                       T sum{};
-                       for (int i : stdv::iota(std::size_t(0), lhs.get_width())) {
-                           auto prod = lhs.at(i, coord.second) * rhs.at(coord.first, i);
-                           sum += prod;
-                       }
-                       return sum;
-                   });
+        static matrix zeroed(std::size_t width, std::size_t height) {
+            return matrix(long(width), std::size_t(width * height));
         }
-    public:
-        constexpr matrix& operator+=(const matrix& other) {
-            if (this->get_dimensions() != other.get_dimensions()) {
-                throw invalid_matrix_dimensions(*this, other, '+');
+
+        static void check_multiplication(const matrix& dest, const matrix& lhs, const matrix& rhs) {
+            if (lhs.get_width() != rhs.get_height() || dest.get_width() != rhs.get_width()
+                || dest.get_height() != lhs.get_height()) {
+                throw invalid_matrix_dimensions(lhs, rhs, dest, '*');
             }
-            std::transform(this->data.begin(),
-                           this->data.end(),
-                           other.data.begin(),
-                           this->data.begin(),
-                           [](const auto& a, const auto& b) { return a + b; });
+        }
+    public:
+        matrix() = default;
+        matrix(matrix&&) = default;
+        matrix(const matrix&) = default;
+        matrix& operator=(matrix&&) = default;
+        matrix& operator=(const matrix&) = default;
+
+        // Evaluates an expression of +, -, scalar * and / and products in one pass
+        template <matrix_expression E>
+        requires(!std::same_as<E, matrix>)
+        matrix(const E& e) : matrix(zeroed(e.get_width(), e.get_height())) {
+            e.assign_to(std::data(this->data));
+        }
+
+        template <matrix_expression E>
+        requires(!std::same_as<E, matrix>)
+        matrix& operator=(const E& e) {
+            // a resize frees the storage e may still refer to, so it only happens once e is evaluated
+            if (this->get_width() != e.get_width() || this->get_height() != e.get_height()
+                || details::may_overlap(e, std::data(this->data), this->data.size()))
+                return *this = matrix(e);
+            e.assign_to(std::data(this->data));
             return *this;
         }
-        constexpr matrix operator+(const matrix& other) const {
-            matrix sum = *this;
-            sum += other;
-            return sum;
+
+        [[nodiscard]] const T& element(std::size_t i) const { return this->data[i]; }
+
+        [[nodiscard]] strided_block<const T> block() const {
+            return {std::data(this->data), this->get_height(), this->get_width(), std::ptrdiff_t(this->get_width())};
         }
-        constexpr matrix& operator-=(const matrix& other) {
-            if (this->get_dimensions() != other.get_dimensions()) {
-                throw invalid_matrix_dimensions(*this, other, '-');
+
+        void assign_to(T* dest) const { std::copy(this->data.begin(), this->data.end(), dest); }
+
+        template <matrix_expression E>
+        matrix& operator+=(const E& other) {
+            if (this->get_width() != other.get_width() || this->get_height() != other.get_height()) {
+                throw invalid_matrix_dimensions(*this, other, '+');
+            }
+            if constexpr (elementwise_expression<E>) {
+                if (details::may_overlap(other, std::data(this->data), this->data.size()))
+                    return *this += matrix(other);
+                for (std::size_t i = 0; i < this->data.size(); ++i)
+                    this->data[i] += other.element(i);
+            } else {
+                *this += matrix(other);
             }
-            std::transform(this->data.begin(),
-                           this->data.end(),
-                           other.data.begin(),
-                           this->data.begin(),
-                           [](const auto& a, const auto& b) { return a - b; });
             return *this;
         }
 
-        constexpr matrix operator-(const matrix& other) const {
-            matrix sum = *this;
-            sum -= other;
-            return sum;
-        }
-
-        constexpr matrix operator*(const matrix& other) const {
-            if (this->get_width() != other.get_height()) {
-                throw invalid_matrix_dimensions(*this, other, '*');
+        template <matrix_expression E>
+        matrix& operator-=(const E& other) {
+            if (this->get_width() != other.get_width() || this->get_height() != other.get_height()) {
+                throw invalid_matrix_dimensions(*this, other, '-');
             }
-            int new_width = other.get_width();
-            auto new_input = get_multiplication_stream(*this, other);
-            return matrix(new_width, new_input);
+            if constexpr (elementwise_expression<E>) {
+                if (details::may_overlap(other, std::data(this->data), this->data.size()))
+                    return *this -= matrix(other);
+                for (std::size_t i = 0; i < this->data.size(); ++i)
+                    this->data[i] -= other.element(i);
+            } else {
+                *this -= matrix(other);
+            }
+            return *this;
         }
 
         template <typename Scalar>
-        requires requires(T t, Scalar s) {
+        requires(!matrix_expression<Scalar>) && requires(T t, Scalar s) {
             { t* s } -> std::convertible_to<T>;
         }
         constexpr matrix& operator*=(const Scalar& i) {
@@ -113,14 +101,9 @@ namespace ox {
             return *this;
         }
 
-        template <typename Scalar, typename... TemplateArgs>
-        requires requires(T t, Scalar s) {
-            { t* s } -> std::convertible_to<T>;
-        }
-        constexpr inline friend matrix<TemplateArgs...> operator*(const Scalar& s, const matrix<TemplateArgs...>& m) {
-            auto cpy = m;
-            cpy *= s;
-            return cpy;
+        template <matrix_expression E>
+        matrix& operator*=(const E& other) {
+            return *this = *this * other;
         }
 
         template <typename Scalar>
@@ -132,32 +115,85 @@ namespace ox {
             return *this;
         }
 
-        template <typename Scalar, typename... TemplateArgs>
-        requires requires(T t, Scalar s) {
-            { t / s } -> std::convertible_to<T>;
+        // dest = lhs * rhs without allocating dest; dest may be lhs or rhs, at the cost of a temporary
+        static void in_place_multiplication(matrix& dest, const matrix& lhs, const matrix& rhs) {
+            check_multiplication(dest, lhs, rhs);
+            (lhs * rhs).assign_to(std::data(dest.data));
         }
-        constexpr inline matrix operator/(const Scalar& s) {
-            auto cpy = *this;
-            cpy /= s;
-            return cpy;
+
+        // As above, with the rows of dest split over pool and the calling thread, so it may run inside a pool task
+        static void in_place_multiplication(matrix& dest, const matrix& lhs, const matrix& rhs,
+                                            thread_pool<std::function<void()>>& pool) {
+            check_multiplication(dest, lhs, rhs);
+            if (&dest == &lhs || &dest == &rhs) {
+                matrix to_return = zeroed(rhs.get_width(), lhs.get_height());
+                in_place_multiplication(to_return, lhs, rhs, pool);
+                dest = std::move(to_return);
+                return;
+            }
+            details::gemm(lhs.block(), rhs.block(), std::data(dest.data), dest.get_width(), pool);
         }
 
-        constexpr static void in_place_multiplication(matrix& dest, const matrix& lhs, const matrix& rhs) {
-            if (lhs.get_width() != rhs.get_height() && dest.get_width() == rhs.get_width()
-                && dest.get_height() == lhs.get_height()) {
-                throw invalid_matrix_dimensions(lhs, rhs, dest, '*');
+        static matrix identity(std::size_t size) {
+            matrix to_return = zeroed(size, size);
+            for (std::size_t i = 0; i < size; ++i)
+                to_return.data[i * size + i] = T(1);
+            return to_return;
+        }
+
+        // Square and multiply over two preallocated buffers that are swapped, so no step allocates
+        [[nodiscard]] matrix pow(std::uint64_t exponent) const {
+            if (this->get_width() != this->get_height()) {
+                throw invalid_matrix_dimensions(*this, *this, '^');
+            }
+            matrix result = identity(this->get_width());
+            matrix base = *this;
+            matrix scratch = zeroed(this->get_width(), this->get_height());
+            for (; exponent; exponent >>= 1) {
+                if (exponent & 1) {
+                    in_place_multiplication(scratch, result, base);
+                    std::swap(result, scratch);
+                }
+                if (exponent > 1) {
+                    in_place_multiplication(scratch, base, base);
+                    std::swap(base, scratch);
+                }
             }
-            auto new_input = get_multiplication_stream(lhs, rhs);
-            std::copy(new_input.begin(), new_input.end(), dest.data.begin());
+            return result;
+        }
+
+        [[nodiscard]] matrix transpose() const {
+            matrix to_return = zeroed(this->get_height(), this->get_width());
+            details::blocked_copy(block().transposed(), std::data(to_return.data), to_return.get_width());
+            return to_return;
+        }
+
+        // Square matrices swap tiles in place, others go through one buffer
+        matrix& transpose_in_place() {
+            if (this->get_width() == this->get_height())
+                details::blocked_transpose_in_place(std::data(this->data), this->get_width());
+            else
+                *this = transpose();
+            return *this;
         }
 
-        constexpr matrix transpose() const {
-            auto new_input = std::views::iota(std::size_t(0), this->get_size())
-                           | std::views::transform([this](std::size_t index) -> int {
-                                 return this->get(index / this->get_height(), index % this->get_height());
-                             });
-            return matrix(this->get_height(), new_input);
+        [[nodiscard]] matrix_view<const T> view() const { return matrix_view<const T>(*this); }
+        [[nodiscard]] matrix_view<T> view() { return matrix_view<T>(*this); }
+        [[nodiscard]] matrix_view<const T> transposed_view() const { return view().transposed(); }
+        [[nodiscard]] matrix_view<T> transposed_view() { return view().transposed(); }
+
+        [[nodiscard]] matrix_view<const T> submatrix(std::size_t x, std::size_t y, std::size_t width,
+                                                     std::size_t height) const {
+            return view().submatrix(x, y, width, height);
         }
+        [[nodiscard]] matrix_view<T> submatrix(std::size_t x, std::size_t y, std::size_t width, std::size_t height) {
+            return view().submatrix(x, y, width, height);
+        }
+
+        [[nodiscard]] matrix_view<const T> row(std::size_t y) const { return view().row(y); }
+        [[nodiscard]] matrix_view<T> row(std::size_t y) { return view().row(y); }
+        [[nodiscard]] matrix_view<const T> column(std::size_t x) const { return view().column(x); }
+        [[nodiscard]] matrix_view<T> column(std::size_t x) { return view().column(x); }
 
         void print_matrix()
         requires std::integral<T>
@@ -0,0 +1,441 @@
+#ifndef OXLIB__MATRIX_DECOMPOSITION_H
+#define OXLIB__MATRIX_DECOMPOSITION_H
+
+#include <algorithm>
+#include <cmath>
+#include <concepts>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "_matrix.h"
+#include <ox/math.h>
+
+namespace ox {
+    struct singular_matrix_error : std::domain_error {
+        using std::domain_error::domain_error;
+    };
+
+    struct not_positive_definite_error : std::domain_error {
+        using std::domain_error::domain_error;
+    };
+
+    namespace details {
+        template <typename T>
+        struct is_rational : std::false_type {};
+        template <typename Int>
+        struct is_rational<basic_rational<Int>> : std::true_type {};
+
+        // Integers and fractions, where dividing is exact only when it was known to be
+        template <typename T>
+        concept exact_ring = std::integral<T> || is_rational<T>::value;
+
+        template <typename T>
+        T* row(matrix<T>& m, std::size_t r) {
+            return std::data(m.get_raw()) + r * m.get_width();
+        }
+
+        template <typename T>
+        const T* row(const matrix<T>& m, std::size_t r) {
+            return std::data(m.get_raw()) + r * m.get_width();
+        }
+
+        template <typename T>
+        void swap_rows(matrix<T>& m, std::size_t a, std::size_t b) {
+            std::swap_ranges(row(m, a), row(m, a) + m.get_width(), row(m, b));
+        }
+
+        template <typename T>
+        void check_square(const matrix<T>& m, char op) {
+            if (m.get_width() != m.get_height())
+                throw invalid_matrix_dimensions(m, m, op);
+        }
+    } // namespace details
+
+    template <typename T>
+    struct lu_decomposition {
+        // unit lower L below the diagonal, U on and above it
+        matrix<T> lu;
+        // row i of lu came from row permutation[i] of the input
+        std::vector<std::size_t> permutation;
+        bool odd_permutation = false;
+        bool singular = false;
+
+        [[nodiscard]] T determinant() const {
+            T to_return = odd_permutation ? T(-1) : T(1);
+            for (std::size_t i = 0; i < lu.get_width(); ++i)
+                to_return = to_return * details::row(lu, i)[i];
+            return to_return;
+        }
+
+        // X with input * X = b, b holding one right hand side per column
+        [[nodiscard]] matrix<T> solve(const matrix<T>& b) const {
+            std::size_t n = lu.get_width();
+            if (b.get_height() != n)
+                throw invalid_matrix_dimensions(lu, b, '\\');
+            if (singular)
+                throw singular_matrix_error("Matrix is singular");
+            std::size_t m = b.get_width();
+            matrix<T> x = b;
+            for (std::size_t i = 0; i < n; ++i)
+                std::copy_n(details::row(b, permutation[i]), m, details::row(x, i));
+            // rows are updated as a whole, so every inner loop runs over contiguous memory
+            for (std::size_t i = 0; i < n; ++i) {
+                T* xi = details::row(x, i);
+                const T* li = details::row(lu, i);
+                for (std::size_t k = 0; k < i; ++k) {
+                    const T* xk = details::row(x, k);
+                    for (std::size_t j = 0; j < m; ++j)
+                        xi[j] = xi[j] - li[k] * xk[j];
+                }
+            }
+            for (std::size_t i = n; i-- > 0;) {
+                T* xi = details::row(x, i);
+                const T* ui = details::row(lu, i);
+                for (std::size_t k = i + 1; k < n; ++k) {
+                    const T* xk = details::row(x, k);
+                    for (std::size_t j = 0; j < m; ++j)
+                        xi[j] = xi[j] - ui[k] * xk[j];
+                }
+                T inverse = reciprocal(ui[i]);
+                for (std::size_t j = 0; j < m; ++j)
+                    xi[j] = xi[j] * inverse;
+            }
+            return x;
+        }
+
+        [[nodiscard]] std::vector<T> solve(std::span<const T> b) const {
+            matrix<T> x = solve(matrix<T>(1, std::vector<T>(b.begin(), b.end())));
+            return std::vector<T>(x.get_raw().begin(), x.get_raw().end());
+        }
+
+        [[nodiscard]] matrix<T> inverse() const { return solve(matrix<T>::identity(lu.get_width())); }
+    };
+
+    /*
+     * LU decomposition with partial pivoting, overwriting m (pass an rvalue to avoid the copy).
+     * Right-looking and blocked: each panel of block columns is factored, then the trailing submatrix is updated
+     * with one call to the GEMM kernel. Floating point picks the largest pivot in the column, exact fields
+     * (ox::modulo, ox::rational) the first non-zero one.
+     */
+    template <typename T>
+    requires(!std::integral<T>)
+    lu_decomposition<T> lu(matrix<T> m) {
+        details::check_square(m, 'L');
+        constexpr std::size_t block = 64;
+        std::size_t n = m.get_width();
+        lu_decomposition<T> to_return{std::move(m), std::vector<std::size_t>(n)};
+        matrix<T>& a = to_return.lu;
+        std::iota(to_return.permutation.begin(), to_return.permutation.end(), std::size_t(0));
+        std::vector<T> update;
+
+        for (std::size_t kb = 0; kb < n; kb += block) {
+            std::size_t k_end = std::min(n, kb + block);
+            for (std::size_t k = kb; k < k_end; ++k) {
+                std::size_t pivot = k;
+                if constexpr (std::floating_point<T>) {
+                    for (std::size_t i = k + 1; i < n; ++i)
+                        if (std::abs(details::row(a, i)[k]) > std::abs(details::row(a, pivot)[k]))
+                            pivot = i;
+                } else {
+                    while (pivot < n && details::row(a, pivot)[k] == T(0))
+                        ++pivot;
+                    pivot = pivot == n ? k : pivot;
+                }
+                if (details::row(a, pivot)[k] == T(0)) {
+                    to_return.singular = true;
+                    continue;
+                }
+                if (pivot != k) {
+                    details::swap_rows(a, pivot, k);
+                    std::swap(to_return.permutation[pivot], to_return.permutation[k]);
+                    to_return.odd_permutation = !to_return.odd_permutation;
+                }
+                const T* ak = details::row(a, k);
+                T inverse = reciprocal(ak[k]);
+                for (std::size_t i = k + 1; i < n; ++i) {
+                    T* ai = details::row(a, i);
+                    ai[k] = ai[k] * inverse;
+                    for (std::size_t j = k + 1; j < k_end; ++j)
+                        ai[j] = ai[j] - ai[k] * ak[j];
+                }
+            }
+            if (k_end == n)
+                break;
+
+            // U12 = L11^-1 A12
+            for (std::size_t k = kb; k < k_end; ++k) {
+                const T* ak = details::row(a, k);
+                for (std::size_t i = k + 1; i < k_end; ++i) {
+                    T* ai = details::row(a, i);
+                    for (std::size_t j = k_end; j < n; ++j)
+                        ai[j] = ai[j] - ai[k] * ak[j];
+                }
+            }
+            // A22 -= L21 U12
+            std::size_t rest = n - k_end;
+            update.resize(rest * rest);
+            strided_block<const T> whole = a.block();
+            details::gemm(whole.sub(k_end, kb, rest, k_end - kb), whole.sub(kb, k_end, k_end - kb, rest),
+                          update.data(), rest);
+            for (std::size_t i = 0; i < rest; ++i) {
+                T* ai = details::row(a, k_end + i) + k_end;
+                const T* ui = update.data() + i * rest;
+                for (std::size_t j = 0; j < rest; ++j)
+                    ai[j] = ai[j] - ui[j];
+            }
+        }
+        return to_return;
+    }
+
+    // Fraction-free Gaussian elimination: every division is exact, so integer matrices stay integral
+    template <typename T>
+    T bareiss_determinant(matrix<T> m) {
+        details::check_square(m, 'D');
+        std::size_t n = m.get_width();
+        T sign = T(1);
+        T previous = T(1);
+        for (std::size_t k = 0; k < n; ++k) {
+            if (details::row(m, k)[k] == T(0)) {
+                std::size_t pivot = k + 1;
+                while (pivot < n && details::row(m, pivot)[k] == T(0))
+                    ++pivot;
+                if (pivot == n)
+                    return T(0);
+                details::swap_rows(m, pivot, k);
+                sign = T(0) - sign;
+            }
+            const T* ak = details::row(m, k);
+            for (std::size_t i = k + 1; i < n; ++i) {
+                T* ai = details::row(m, i);
+                for (std::size_t j = k + 1; j < n; ++j)
+                    ai[j] = (ai[j] * ak[k] - ai[k] * ak[j]) / previous;
+            }
+            previous = ak[k];
+        }
+        return n == 0 ? T(1) : sign * details::row(m, n - 1)[n - 1];
+    }
+
+    // Exact through Bareiss for integers and ox::rational, through LU otherwise
+    template <typename T>
+    T determinant(const matrix<T>& m) {
+        if constexpr (details::exact_ring<T>)
+            return bareiss_determinant(m);
+        else
+            return lu(m).determinant();
+    }
+
+    template <typename T>
+    requires(!std::integral<T>)
+    matrix<T> inverse(const matrix<T>& m) {
+        return lu(m).inverse();
+    }
+
+    template <std::floating_point T>
+    struct qr_decomposition {
+        // R on and above the diagonal, Householder vectors (with an implicit leading 1) below it
+        matrix<T> qr;
+        std::vector<T> tau;
+
+        [[nodiscard]] matrix<T> r() const {
+            std::size_t n = qr.get_width();
+            matrix<T> to_return(long(n), std::size_t(n * n));
+            for (std::size_t i = 0; i < std::min(n, qr.get_height()); ++i)
+                std::copy(details::row(qr, i) + i, details::row(qr, i) + n, details::row(to_return, i) + i);
+            return to_return;
+        }
+
+        // Applies Q^T to b in place, one reflector at a time
+        void apply_qt(matrix<T>& b) const {
+            std::size_t rows = qr.get_height(), m = b.get_width();
+            std::vector<T> w(m);
+            for (std::size_t k = 0; k < tau.size(); ++k) {
+                if (tau[k] == T(0))
+                    continue;
+                std::copy_n(details::row(b, k), m, w.begin());
+                for (std::size_t i = k + 1; i < rows; ++i) {
+                    T v = details::row(qr, i)[k];
+                    const T* bi = details::row(b, i);
+                    for (std::size_t j = 0; j < m; ++j)
+                        w[j] += v * bi[j];
+                }
+                for (std::size_t i = k; i < rows; ++i) {
+                    T v = i == k ? T(1) : details::row(qr, i)[k];
+                    T* bi = details::row(b, i);
+                    for (std::size_t j = 0; j < m; ++j)
+                        bi[j] -= tau[k] * v * w[j];
+                }
+            }
+        }
+
+        // Thin Q, with as many columns as the decomposed matrix
+        [[nodiscard]] matrix<T> q() const {
+            std::size_t rows = qr.get_height(), n = qr.get_width();
+            matrix<T> to_return(long(n), std::size_t(rows * n));
+            for (std::size_t i = 0; i < n; ++i)
+                details::row(to_return, i)[i] = T(1);
+            std::vector<T> w(n);
+            for (std::size_t k = tau.size(); k-- > 0;) {
+                if (tau[k] == T(0))
+                    continue;
+                std::fill(w.begin(), w.end(), T(0));
+                for (std::size_t i = k; i < rows; ++i) {
+                    T v = i == k ? T(1) : details::row(qr, i)[k];
+                    const T* qi = details::row(to_return, i);
+                    for (std::size_t j = 0; j < n; ++j)
+                        w[j] += v * qi[j];
+                }
+                for (std::size_t i = k; i < rows; ++i) {
+                    T v = i == k ? T(1) : details::row(qr, i)[k];
+                    T* qi = details::row(to_return, i);
+                    for (std::size_t j = 0; j < n; ++j)
+                        qi[j] -= tau[k] * v * w[j];
+                }
+            }
+            return to_return;
+        }
+
+        // X minimising |input * X - b| per column of b
+        [[nodiscard]] matrix<T> least_squares(matrix<T> b) const {
+            std::size_t n = qr.get_width();
+            if (b.get_height() != qr.get_height())
+                throw invalid_matrix_dimensions(qr, b, '\\');
+            apply_qt(b);
+            std::size_t m = b.get_width();
+            matrix<T> x(long(m), std::size_t(n * m));
+            for (std::size_t i = n; i-- > 0;) {
+                T* xi = details::row(x, i);
+                const T* ri = details::row(qr, i);
+                std::copy_n(details::row(b, i), m, xi);
+                for (std::size_t k = i + 1; k < n; ++k) {
+                    const T* xk = details::row(x, k);
+                    for (std::size_t j = 0; j < m; ++j)
+                        xi[j] -= ri[k] * xk[j];
+                }
+                if (ri[i] == T(0))
+                    throw singular_matrix_error("Matrix is rank deficient");
+                for (std::size_t j = 0; j < m; ++j)
+                    xi[j] /= ri[i];
+            }
+            return x;
+        }
+    };
+
+    /*
+     * Householder QR of a matrix with at least as many rows as columns, overwriting m.
+     * Each reflector is applied to the trailing columns row by row (w = v^T A, then A -= tau v w), so every
+     * pass over the matrix streams through contiguous rows.
+     */
+    template <std::floating_point T>
+    qr_decomposition<T> qr(matrix<T> m) {
+        std::size_t rows = m.get_height(), n = m.get_width();
+        if (rows < n)
+            throw invalid_matrix_dimensions(m, m, 'Q');
+        qr_decomposition<T> to_return{std::move(m), std::vector<T>(std::min(rows - 1, n))};
+        matrix<T>& a = to_return.qr;
+        std::vector<T> w(n);
+        for (std::size_t k = 0; k < to_return.tau.size(); ++k) {
+            T norm = 0;
+            for (std::size_t i = k; i < rows; ++i)
+                norm += details::row(a, i)[k] * details::row(a, i)[k];
+            norm = std::sqrt(norm);
+            T head = details::row(a, k)[k];
+            if (norm == T(0))
+                continue;
+            T beta = head > 0 ? -norm : norm;
+            to_return.tau[k] = (beta - head) / beta;
+            T scale = T(1) / (head - beta);
+            for (std::size_t i = k + 1; i < rows; ++i)
+                details::row(a, i)[k] *= scale;
+            details::row(a, k)[k] = beta;
+
+            std::fill(w.begin() + k + 1, w.end(), T(0));
+            for (std::size_t i = k; i < rows; ++i) {
+                T v = i == k ? T(1) : details::row(a, i)[k];
+                const T* ai = details::row(a, i);
+                for (std::size_t j = k + 1; j < n; ++j)
+                    w[j] += v * ai[j];
+            }
+            for (std::size_t i = k; i < rows; ++i) {
+                T v = i == k ? T(1) : details::row(a, i)[k];
+                T* ai = details::row(a, i);
+                for (std::size_t j = k + 1; j < n; ++j)
+                    ai[j] -= to_return.tau[k] * v * w[j];
+            }
+        }
+        return to_return;
+    }
+
+    template <std::floating_point T>
+    matrix<T> least_squares(const matrix<T>& a, matrix<T> b) {
+        return qr(a).least_squares(std::move(b));
+    }
+
+    template <std::floating_point T>
+    struct cholesky_decomposition {
+        // lower triangular L with input = L L^T
+        matrix<T> l;
+
+        [[nodiscard]] matrix<T> solve(matrix<T> b) const {
+            std::size_t n = l.get_width(), m = b.get_width();
+            if (b.get_height() != n)
+                throw invalid_matrix_dimensions(l, b, '\\');
+            for (std::size_t i = 0; i < n; ++i) {
+                T* bi = details::row(b, i);
+                const T* li = details::row(l, i);
+                for (std::size_t k = 0; k < i; ++k) {
+                    const T* bk = details::row(b, k);
+                    for (std::size_t j = 0; j < m; ++j)
+                        bi[j] -= li[k] * bk[j];
+                }
+                for (std::size_t j = 0; j < m; ++j)
+                    bi[j] /= li[i];
+            }
+            // L^T x = y, reading L^T's rows as L's columns
+            for (std::size_t i = n; i-- > 0;) {
+                T* bi = details::row(b, i);
+                for (std::size_t j = 0; j < m; ++j)
+                    bi[j] /= details::row(l, i)[i];
+                for (std::size_t k = 0; k < i; ++k) {
+                    T lik = details::row(l, i)[k];
+                    T* bk = details::row(b, k);
+                    for (std::size_t j = 0; j < m; ++j)
+                        bk[j] -= lik * bi[j];
+                }
+            }
+            return b;
+        }
+    };
+
+    /*
+     * Cholesky factor of a symmetric positive definite matrix, overwriting m; only its lower triangle is read.
+     * Row-oriented (Cholesky-Crout): every entry is a dot product of two contiguous row prefixes of L.
+     */
+    template <std::floating_point T>
+    cholesky_decomposition<T> cholesky(matrix<T> m) {
+        details::check_square(m, 'C');
+        std::size_t n = m.get_width();
+        for (std::size_t i = 0; i < n; ++i) {
+            T* li = details::row(m, i);
+            for (std::size_t j = 0; j <= i; ++j) {
+                const T* lj = details::row(m, j);
+                T sum = li[j];
+                for (std::size_t k = 0; k < j; ++k)
+                    sum -= li[k] * lj[k];
+                if (i == j) {
+                    if (!(sum > T(0)))
+                        throw not_positive_definite_error("Matrix is not positive definite");
+                    li[i] = std::sqrt(sum);
+                } else {
+                    li[j] = sum / lj[j];
+                }
+            }
+            std::fill(li + i + 1, li + n, T(0));
+        }
+        return {std::move(m)};
+    }
+} // namespace ox
+
+#endif // OXLIB__MATRIX_DECOMPOSITION_H
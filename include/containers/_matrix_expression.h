@@ -0,0 +1,271 @@
+#ifndef OXLIB__MATRIX_EXPRESSION_H
+#define OXLIB__MATRIX_EXPRESSION_H
+
+#include <concepts>
+#include <cstdio>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <vector>
+#include "_gemm.h"
+
+namespace ox {
+    template <typename T, typename Container = std::vector<T>>
+    class matrix;
+
+    struct invalid_matrix_dimensions : public std::exception {
+        char message[120]{};
+
+        invalid_matrix_dimensions(const auto& a, const auto& b, char op) {
+            snprintf(message,
+                     sizeof(message),
+                     "Invalid dimensions: %zu x %zu and %zu x %zu for operator %c",
+                     std::size_t(a.get_width()),
+                     std::size_t(a.get_height()),
+                     std::size_t(b.get_width()),
+                     std::size_t(b.get_height()),
+                     op);
+        }
+
+        invalid_matrix_dimensions(const auto& a, const auto& b, const auto& dest, char op) {
+            snprintf(message,
+                     sizeof(message),
+                     "Invalid dimensions: %zu x %zu and %zu x %zu for operator %c to %zu x %zu",
+                     std::size_t(a.get_width()),
+                     std::size_t(a.get_height()),
+                     std::size_t(b.get_width()),
+                     std::size_t(b.get_height()),
+                     op,
+                     std::size_t(dest.get_width()),
+                     std::size_t(dest.get_height()));
+        }
+
+        [[nodiscard]] const char* what() const noexcept override { return message; }
+    };
+
+    /*
+     * Lazy matrix arithmetic.
+     * +, - and scalar * and / build expression nodes instead of matrices. Assigning a node to a matrix, or
+     * constructing one from it, evaluates the whole elementwise chain in one pass with no temporaries.
+     * A product is a single node evaluated straight into its destination by the GEMM kernel; used inside an
+     * elementwise chain it is materialised once.
+     * Nodes keep matrices by reference, so they must not outlive the full expression unless assigned.
+     */
+    template <typename E>
+    concept matrix_expression = requires(const E& e, typename E::value_type* dest) {
+        { e.get_width() } -> std::convertible_to<std::size_t>;
+        { e.get_height() } -> std::convertible_to<std::size_t>;
+        e.assign_to(dest);
+    };
+
+    // Expressions whose elements can be read one at a time, by row-major index
+    template <typename E>
+    concept elementwise_expression = matrix_expression<E> && requires(const E& e, std::size_t i) { e.element(i); };
+
+    // Expressions backed by strided storage, which the GEMM kernel reads in place
+    template <typename E>
+    concept strided_expression = matrix_expression<E> && requires(const E& e) {
+        { e.block() } -> std::convertible_to<strided_block<const typename E::value_type>>;
+    };
+
+    namespace details {
+        template <typename M>
+        class matrix_reference {
+            const M* m;
+        public:
+            using value_type = typename M::value_type;
+
+            matrix_reference(const M& _m) : m(&_m) {}
+
+            [[nodiscard]] std::size_t get_width() const { return m->get_width(); }
+            [[nodiscard]] std::size_t get_height() const { return m->get_height(); }
+            [[nodiscard]] decltype(auto) element(std::size_t i) const { return m->element(i); }
+            [[nodiscard]] auto block() const { return m->block(); }
+            void assign_to(value_type* dest) const { m->assign_to(dest); }
+        };
+
+        // How a node stores an operand: matrices by reference, other nodes by value, products materialised
+        template <typename E>
+        struct elementwise_operand {
+            using type = matrix<typename E::value_type>;
+        };
+        template <elementwise_expression E>
+        struct elementwise_operand<E> {
+            using type = E;
+        };
+        template <typename T, typename C>
+        struct elementwise_operand<matrix<T, C>> {
+            using type = matrix_reference<matrix<T, C>>;
+        };
+
+        template <typename E>
+        struct product_operand {
+            using type = matrix<typename E::value_type>;
+        };
+        template <strided_expression E>
+        struct product_operand<E> {
+            using type = E;
+        };
+        template <typename T, typename C>
+        struct product_operand<matrix<T, C>> {
+            using type = matrix_reference<matrix<T, C>>;
+        };
+
+        template <typename T>
+        bool overlaps(const T* dest, std::size_t n, strided_block<const T> b) {
+            if (b.rows == 0 || b.cols == 0 || n == 0)
+                return false;
+            const T* last = &b(b.rows - 1, b.cols - 1);
+            const T* first = std::min(b.data, last, std::less<>());
+            last = std::max(b.data, last, std::less<>());
+            return !std::less<>()(last, dest) && std::less<>()(first, dest + n);
+        }
+
+        // Whether evaluating e into dest could read an element after it was overwritten
+        template <typename E>
+        bool may_overlap(const E& e, const typename E::value_type* dest, std::size_t n) {
+            if constexpr (requires { e.overlaps(dest, n); })
+                return e.overlaps(dest, n);
+            return false;
+        }
+
+        struct multiplies_from_left {
+            template <typename A, typename S>
+            constexpr auto operator()(const A& a, const S& s) const {
+                return s * a;
+            }
+        };
+    } // namespace details
+
+    template <typename L, typename R, typename Op>
+    class matrix_elementwise {
+        typename details::elementwise_operand<L>::type lhs;
+        typename details::elementwise_operand<R>::type rhs;
+        [[no_unique_address]] Op op;
+    public:
+        using value_type = typename L::value_type;
+
+        matrix_elementwise(const L& l, const R& r, char symbol) : lhs(l), rhs(r) {
+            if (lhs.get_width() != rhs.get_width() || lhs.get_height() != rhs.get_height())
+                throw invalid_matrix_dimensions(l, r, symbol);
+        }
+
+        [[nodiscard]] std::size_t get_width() const { return lhs.get_width(); }
+        [[nodiscard]] std::size_t get_height() const { return lhs.get_height(); }
+
+        [[nodiscard]] value_type element(std::size_t i) const { return op(lhs.element(i), rhs.element(i)); }
+
+        [[nodiscard]] bool overlaps(const value_type* dest, std::size_t n) const {
+            return details::may_overlap(lhs, dest, n) || details::may_overlap(rhs, dest, n);
+        }
+
+        void assign_to(value_type* dest) const {
+            std::size_t n = get_width() * get_height();
+            for (std::size_t i = 0; i < n; ++i)
+                dest[i] = element(i);
+        }
+    };
+
+    template <typename E, typename S, typename Op>
+    class matrix_scalar {
+        typename details::elementwise_operand<E>::type expression;
+        S scalar;
+        [[no_unique_address]] Op op;
+    public:
+        using value_type = typename E::value_type;
+
+        matrix_scalar(const E& e, const S& s) : expression(e), scalar(s) {}
+
+        [[nodiscard]] std::size_t get_width() const { return expression.get_width(); }
+        [[nodiscard]] std::size_t get_height() const { return expression.get_height(); }
+
+        [[nodiscard]] value_type element(std::size_t i) const { return op(expression.element(i), scalar); }
+
+        [[nodiscard]] bool overlaps(const value_type* dest, std::size_t n) const {
+            return details::may_overlap(expression, dest, n);
+        }
+
+        void assign_to(value_type* dest) const {
+            std::size_t n = get_width() * get_height();
+            for (std::size_t i = 0; i < n; ++i)
+                dest[i] = element(i);
+        }
+    };
+
+    template <typename L, typename R>
+    class matrix_product {
+        typename details::product_operand<L>::type lhs;
+        typename details::product_operand<R>::type rhs;
+    public:
+        using value_type = typename L::value_type;
+
+        matrix_product(const L& l, const R& r) : lhs(l), rhs(r) {
+            if (lhs.get_width() != rhs.get_height())
+                throw invalid_matrix_dimensions(l, r, '*');
+        }
+
+        [[nodiscard]] std::size_t get_width() const { return rhs.get_width(); }
+        [[nodiscard]] std::size_t get_height() const { return lhs.get_height(); }
+
+        // Every element of dest depends on a whole row and column, so any shared storage counts
+        [[nodiscard]] bool overlaps(const value_type* dest, std::size_t n) const {
+            return details::overlaps<value_type>(dest, n, lhs.block())
+                   || details::overlaps<value_type>(dest, n, rhs.block());
+        }
+
+        void assign_to(value_type* dest) const {
+            strided_block<const value_type> a = lhs.block();
+            strided_block<const value_type> b = rhs.block();
+            std::size_t n = get_width() * get_height();
+            if (overlaps(dest, n)) {
+                std::unique_ptr<value_type[]> result(new value_type[n]);
+                details::gemm(a, b, result.get(), get_width());
+                std::copy_n(result.get(), n, dest);
+            } else {
+                details::gemm(a, b, dest, get_width());
+            }
+        }
+    };
+
+    template <matrix_expression L, matrix_expression R>
+    auto operator+(const L& l, const R& r) {
+        return matrix_elementwise<L, R, std::plus<>>(l, r, '+');
+    }
+
+    template <matrix_expression L, matrix_expression R>
+    auto operator-(const L& l, const R& r) {
+        return matrix_elementwise<L, R, std::minus<>>(l, r, '-');
+    }
+
+    template <matrix_expression L, matrix_expression R>
+    auto operator*(const L& l, const R& r) {
+        return matrix_product<L, R>(l, r);
+    }
+
+    template <matrix_expression E, typename Scalar>
+    requires(!matrix_expression<Scalar>) && requires(typename E::value_type t, Scalar s) {
+        { t* s } -> std::convertible_to<typename E::value_type>;
+    }
+    auto operator*(const E& e, const Scalar& s) {
+        return matrix_scalar<E, Scalar, std::multiplies<>>(e, s);
+    }
+
+    template <typename Scalar, matrix_expression E>
+    requires(!matrix_expression<Scalar>) && requires(typename E::value_type t, Scalar s) {
+        { s* t } -> std::convertible_to<typename E::value_type>;
+    }
+    auto operator*(const Scalar& s, const E& e) {
+        return matrix_scalar<E, Scalar, details::multiplies_from_left>(e, s);
+    }
+
+    template <matrix_expression E, typename Scalar>
+    requires(!matrix_expression<Scalar>) && requires(typename E::value_type t, Scalar s) {
+        { t / s } -> std::convertible_to<typename E::value_type>;
+    }
+    auto operator/(const E& e, const Scalar& s) {
+        return matrix_scalar<E, Scalar, std::divides<>>(e, s);
+    }
+} // namespace ox
+
+#endif // OXLIB__MATRIX_EXPRESSION_H
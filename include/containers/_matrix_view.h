@@ -0,0 +1,125 @@
+#ifndef OXLIB__MATRIX_VIEW_H
+#define OXLIB__MATRIX_VIEW_H
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "_2d_grid.h"
+#include "_gemm.h"
+#include "_matrix_expression.h"
+
+namespace ox {
+    namespace details {
+        constexpr std::size_t transpose_tile = 32;
+
+        // dest[r * ld + c] = src(r, c), walking strided sources tile by tile so both sides stay in cache
+        template <typename T>
+        void blocked_copy(strided_block<const T> src, T* dest, std::size_t ld) {
+            if (src.col_stride == 1) {
+                for (std::size_t r = 0; r < src.rows; ++r)
+                    std::copy_n(&src(r, 0), src.cols, dest + r * ld);
+                return;
+            }
+            for (std::size_t rb = 0; rb < src.rows; rb += transpose_tile) {
+                std::size_t r_end = std::min(src.rows, rb + transpose_tile);
+                for (std::size_t cb = 0; cb < src.cols; cb += transpose_tile) {
+                    std::size_t c_end = std::min(src.cols, cb + transpose_tile);
+                    for (std::size_t r = rb; r < r_end; ++r)
+                        for (std::size_t c = cb; c < c_end; ++c)
+                            dest[r * ld + c] = src(r, c);
+                }
+            }
+        }
+
+        // Transposes a row-major n x n block in place by swapping mirrored tiles
+        template <typename T>
+        void blocked_transpose_in_place(T* data, std::size_t n) {
+            for (std::size_t rb = 0; rb < n; rb += transpose_tile) {
+                std::size_t r_end = std::min(n, rb + transpose_tile);
+                for (std::size_t cb = rb; cb < n; cb += transpose_tile) {
+                    std::size_t c_end = std::min(n, cb + transpose_tile);
+                    for (std::size_t r = rb; r < r_end; ++r)
+                        for (std::size_t c = cb == rb ? r + 1 : cb; c < c_end; ++c)
+                            std::swap(data[r * n + c], data[c * n + r]);
+                }
+            }
+        }
+    } // namespace details
+
+    /*
+     * Non-owning matrix over strided storage: a whole grid or matrix, a submatrix, a single row or column, or any
+     * of those transposed, all without copying. Views are matrix expressions, so they take part in lazy
+     * arithmetic and products read them in place. Coordinates are (x, y) like grid::at.
+     * A view of non-const T can be written through with assign().
+     */
+    template <typename T>
+    class matrix_view {
+        strided_block<T> view;
+    public:
+        using value_type = std::remove_const_t<T>;
+
+        explicit matrix_view(strided_block<T> b) : view(b) {}
+
+        template <typename Container>
+        matrix_view(grid<value_type, Container>& g) :
+                view{std::data(g.get_raw()), g.get_height(), g.get_width(), std::ptrdiff_t(g.get_width())} {}
+
+        template <typename Container>
+        requires std::is_const_v<T>
+        matrix_view(const grid<value_type, Container>& g) :
+                view{std::data(g.get_raw()), g.get_height(), g.get_width(), std::ptrdiff_t(g.get_width())} {}
+
+        [[nodiscard]] std::size_t get_width() const { return view.cols; }
+        [[nodiscard]] std::size_t get_height() const { return view.rows; }
+
+        [[nodiscard]] T& operator()(std::size_t x, std::size_t y) const { return view(y, x); }
+
+        [[nodiscard]] T& at(std::size_t x, std::size_t y) const {
+            if (x >= view.cols || y >= view.rows)
+                throw std::out_of_range("Index out of range");
+            return view(y, x);
+        }
+
+        [[nodiscard]] const value_type& element(std::size_t i) const { return view(i / view.cols, i % view.cols); }
+
+        [[nodiscard]] strided_block<const value_type> block() const {
+            return {view.data, view.rows, view.cols, view.row_stride, view.col_stride};
+        }
+
+        void assign_to(value_type* dest) const { details::blocked_copy(block(), dest, view.cols); }
+
+        [[nodiscard]] bool overlaps(const value_type* dest, std::size_t n) const {
+            return details::overlaps(dest, n, block());
+        }
+
+        [[nodiscard]] matrix_view transposed() const { return matrix_view(view.transposed()); }
+
+        [[nodiscard]] matrix_view submatrix(std::size_t x, std::size_t y, std::size_t width, std::size_t height) const {
+            if (x + width > view.cols || y + height > view.rows)
+                throw std::out_of_range("Submatrix out of range");
+            return matrix_view(view.sub(y, x, height, width));
+        }
+
+        [[nodiscard]] matrix_view row(std::size_t y) const { return submatrix(0, y, view.cols, 1); }
+        [[nodiscard]] matrix_view column(std::size_t x) const { return submatrix(x, 0, 1, view.rows); }
+
+        // Writes the value of e through the view; e may read the viewed storage
+        template <matrix_expression E>
+        requires(!std::is_const_v<T>)
+        void assign(const E& e) const {
+            if (e.get_width() != view.cols || e.get_height() != view.rows)
+                throw invalid_matrix_dimensions(*this, e, '=');
+            std::size_t n = view.rows * view.cols;
+            std::unique_ptr<value_type[]> values(new value_type[n]);
+            e.assign_to(values.get());
+            for (std::size_t r = 0; r < view.rows; ++r)
+                for (std::size_t c = 0; c < view.cols; ++c)
+                    view(r, c) = values[r * view.cols + c];
+        }
+    };
+} // namespace ox
+
+#endif // OXLIB__MATRIX_VIEW_H
@@ -0,0 +1,308 @@
+#ifndef OXLIB__POOLED_BINARY_TREE_H
+#define OXLIB__POOLED_BINARY_TREE_H
+
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <iterator>
+#include <stdexcept>
+#include <compare>
+#include "_binary_tree.h"
+
+namespace ox {
+    /*
+     * Arena-backed binary tree.
+     * All nodes live in a single vector and link to each other by index, so building a tree costs no
+     * per-node allocation and the whole tree is released at once by clear() or destruction.
+     * Nodes that are unlinked from the root stay in the arena until clear() or compact().
+     */
+    template <typename Value>
+    class pooled_binary_tree {
+    public:
+        class iterator;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using value_type = Value;
+        using index = std::int32_t;
+        constexpr static index npos = -1;
+
+        struct node {
+            Value value;
+            index parent = npos;
+            std::pair<index, index> children{npos, npos};
+
+            template <typename... Args>
+            explicit node(std::in_place_t, Args&&... args) : value(std::forward<Args>(args)...) {}
+        };
+    private:
+        std::vector<node> nodes;
+        index root = npos;
+
+        template <typename TreeNode>
+        index copy_from_node(const TreeNode& source) {
+            index to = emplace(source.value);
+            if (source.children.first)
+                set_left(to, copy_from_node(*source.children.first));
+            if (source.children.second)
+                set_right(to, copy_from_node(*source.children.second));
+            return to;
+        }
+
+        index copy_from_pooled(const pooled_binary_tree& source, index from) {
+            index to = emplace(source.nodes[from].value);
+            auto [left, right] = source.nodes[from].children;
+            if (left != npos)
+                set_left(to, copy_from_pooled(source, left));
+            if (right != npos)
+                set_right(to, copy_from_pooled(source, right));
+            return to;
+        }
+
+        void copy_to_node(index from, binary_tree_node<Value>& dest) const {
+            const node& source = nodes[from];
+            if (source.children.first != npos)
+                copy_to_node(source.children.first, dest.emplace_left(nodes[source.children.first].value));
+            if (source.children.second != npos)
+                copy_to_node(source.children.second, dest.emplace_right(nodes[source.children.second].value));
+        }
+    public:
+        pooled_binary_tree() = default;
+
+        explicit pooled_binary_tree(const binary_tree<Value>& tree) { root = copy_from_node(tree.head); }
+
+        explicit pooled_binary_tree(const binary_tree_node<Value>& tree) { root = copy_from_node(tree); }
+
+        void reserve(std::size_t n) { nodes.reserve(n); }
+
+        void clear() {
+            nodes.clear();
+            root = npos;
+        }
+
+        [[nodiscard]] std::size_t size() const { return nodes.size(); }
+
+        [[nodiscard]] bool empty() const { return root == npos; }
+
+        // Creates a node with no parent
+        template <typename... Args>
+        index emplace(Args&&... args) {
+            nodes.emplace_back(std::in_place, std::forward<Args>(args)...);
+            return index(nodes.size() - 1);
+        }
+
+        template <typename... Args>
+        index emplace_root(Args&&... args) {
+            root = emplace(std::forward<Args>(args)...);
+            return root;
+        }
+
+        template <typename... Args>
+        index emplace_left(index parent, Args&&... args) {
+            index child = emplace(std::forward<Args>(args)...);
+            set_left(parent, child);
+            return child;
+        }
+
+        template <typename... Args>
+        index emplace_right(index parent, Args&&... args) {
+            index child = emplace(std::forward<Args>(args)...);
+            set_right(parent, child);
+            return child;
+        }
+
+        void set_root(index i) {
+            root = i;
+            if (i != npos)
+                nodes[i].parent = npos;
+        }
+
+        void set_left(index parent, index child) {
+            nodes[parent].children.first = child;
+            if (child != npos)
+                nodes[child].parent = parent;
+        }
+
+        void set_right(index parent, index child) {
+            nodes[parent].children.second = child;
+            if (child != npos)
+                nodes[child].parent = parent;
+        }
+
+        // Deep copies the subtree rooted at from into this arena, returning the detached copy
+        index copy_subtree(index from) {
+            index to = emplace(Value(nodes[from].value));
+            auto [left, right] = nodes[from].children;
+            if (left != npos)
+                set_left(to, copy_subtree(left));
+            if (right != npos)
+                set_right(to, copy_subtree(right));
+            return to;
+        }
+
+        // Rebuilds the arena with only the nodes reachable from the root
+        void compact() {
+            if (root == npos) {
+                nodes.clear();
+                return;
+            }
+            pooled_binary_tree cpy;
+            cpy.reserve(nodes.size());
+            cpy.root = cpy.copy_from_pooled(*this, root);
+            *this = std::move(cpy);
+        }
+
+        [[nodiscard]] binary_tree<Value> to_binary_tree() const {
+            if (empty())
+                throw std::out_of_range("Empty tree has no binary_tree form");
+            binary_tree<Value> to_return(nodes[root].value);
+            copy_to_node(root, to_return.head);
+            return to_return;
+        }
+
+        [[nodiscard]] index get_root() const { return root; }
+        [[nodiscard]] index get_left_child(index i) const { return nodes[i].children.first; }
+        [[nodiscard]] index get_right_child(index i) const { return nodes[i].children.second; }
+        [[nodiscard]] index get_parent(index i) const { return nodes[i].parent; }
+        [[nodiscard]] bool has_parent(index i) const { return nodes[i].parent != npos; }
+
+        [[nodiscard]] int get_depth(index i) const {
+            int depth = 0;
+            while ((i = nodes[i].parent) != npos)
+                ++depth;
+            return depth;
+        }
+
+        node& operator[](index i) { return nodes[i]; }
+        const node& operator[](index i) const { return nodes[i]; }
+
+        Value& value(index i) { return nodes[i].value; }
+        const Value& value(index i) const { return nodes[i].value; }
+
+        iterator begin() { return iterator(*this, root); }
+        iterator end() { return iterator(*this, root, true); }
+
+        reverse_iterator rbegin() { return reverse_iterator(end()); }
+        reverse_iterator rend() { return reverse_iterator(begin()); }
+    };
+
+    template <typename Value>
+    class pooled_binary_tree<Value>::iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = pooled_binary_tree::node;
+        using difference_type = int;
+        using pointer = value_type*;
+        using reference = value_type&;
+        using const_pointer = const value_type*;
+        using const_reference = const value_type&;
+    private:
+        using self = pooled_binary_tree<Value>::iterator;
+        pooled_binary_tree* tree = nullptr;
+        index current_node = npos;
+        bool end = false;
+
+        index get_leftmost(index current) const {
+            while ((*tree)[current].children.first != npos)
+                current = (*tree)[current].children.first;
+            return current;
+        }
+
+        index get_rightmost(index current) const {
+            while ((*tree)[current].children.second != npos)
+                current = (*tree)[current].children.second;
+            return current;
+        }
+    public:
+        iterator() : end(true) {}
+
+        iterator(pooled_binary_tree& source, index root, bool _end = false) : tree(&source), end(_end) {
+            if (root != npos)
+                current_node = _end ? get_rightmost(root) : get_leftmost(root);
+            else
+                end = true;
+        }
+
+        reference operator*() const { return (*tree)[current_node]; }
+
+        pointer operator->() const { return &(*tree)[current_node]; }
+
+        // Arena index of the current node
+        [[nodiscard]] index get_index() const { return current_node; }
+
+        self& operator++() {
+            if (current_node != npos && end) {
+                end = false;
+                return *this;
+            }
+            if ((*tree)[current_node].children.second != npos) {
+                current_node = get_leftmost((*tree)[current_node].children.second);
+            } else {
+                auto original_current = current_node;
+                index parent;
+                while ((parent = (*tree)[current_node].parent) != npos
+                       && (*tree)[parent].children.second == current_node) {
+                    current_node = parent;
+                }
+                if (parent == npos) {
+                    current_node = original_current;
+                    end = true;
+                } else {
+                    current_node = parent;
+                }
+            }
+            return *this;
+        }
+
+        self operator++(int) {
+            auto cpy(*this);
+            ++(*this);
+            return cpy;
+        }
+
+        self& operator--() {
+            if (current_node != npos && end) {
+                end = false;
+                return *this;
+            }
+            if ((*tree)[current_node].children.first != npos) {
+                current_node = get_rightmost((*tree)[current_node].children.first);
+            } else {
+                auto original_current = current_node;
+                index parent;
+                while ((parent = (*tree)[current_node].parent) != npos
+                       && (*tree)[parent].children.first == current_node) {
+                    current_node = parent;
+                }
+                if (parent == npos) {
+                    current_node = original_current;
+                    end = true;
+                } else {
+                    current_node = parent;
+                }
+            }
+            return *this;
+        }
+
+        self operator--(int) {
+            auto cpy(*this);
+            --(*this);
+            return cpy;
+        }
+
+        auto operator<=>(const self& other) const {
+            if (other.end && !end) {
+                return std::partial_ordering::less;
+            }
+            return std::partial_ordering::unordered;
+        }
+
+        bool operator==(const self& other) const {
+            if (other.end && end)
+                return true;
+            if (other.end != end)
+                return false;
+            return current_node == other.current_node;
+        }
+    };
+} // namespace ox
+
+#endif // OXLIB__POOLED_BINARY_TREE_H
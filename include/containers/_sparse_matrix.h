@@ -0,0 +1,267 @@
+#ifndef OXLIB__SPARSE_MATRIX_H
+#define OXLIB__SPARSE_MATRIX_H
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "_matrix.h"
+#include "multithreading/parallel_for.h"
+
+namespace ox {
+    template <typename T>
+    class sparse_matrix;
+
+    // Coordinate list builder: entries in any order, duplicates are summed when converted to a sparse_matrix
+    template <typename T>
+    class coo_matrix {
+        friend class sparse_matrix<T>;
+
+        struct entry {
+            std::size_t x, y;
+            T value;
+        };
+
+        std::size_t width = 0, height = 0;
+        std::vector<entry> entries;
+    public:
+        using value_type = T;
+
+        coo_matrix() = default;
+        coo_matrix(std::size_t _width, std::size_t _height) : width(_width), height(_height) {}
+
+        void reserve(std::size_t n) { entries.reserve(n); }
+
+        void add(std::size_t x, std::size_t y, const T& value) {
+            if (x >= width || y >= height)
+                throw std::out_of_range("Index out of range");
+            entries.push_back({x, y, value});
+        }
+
+        [[nodiscard]] std::size_t get_width() const { return width; }
+        [[nodiscard]] std::size_t get_height() const { return height; }
+        [[nodiscard]] std::size_t size() const { return entries.size(); }
+    };
+
+    /*
+     * Compressed sparse row matrix: the non-zeros of row y are values[row_offsets[y] .. row_offsets[y + 1]), in
+     * increasing column order. Memory and products scale with the number of non-zeros rather than width * height.
+     * It is a matrix expression, so it densifies on assignment to a matrix; products with dense matrices and
+     * vectors use the dedicated kernels below.
+     */
+    template <typename T>
+    class sparse_matrix {
+        std::size_t width = 0, height = 0;
+        std::vector<std::size_t> row_offsets{0};
+        std::vector<std::size_t> columns;
+        std::vector<T> values;
+
+        // Row boundaries splitting the non-zeros into roughly equal slices, one per task
+        [[nodiscard]] std::vector<std::size_t> balanced_rows() const {
+            std::size_t tasks = std::max(1u, std::thread::hardware_concurrency());
+            std::vector<std::size_t> to_return{0};
+            for (std::size_t t = 1; t < tasks; ++t) {
+                std::size_t target = non_zeros() * t / tasks;
+                auto it = std::upper_bound(row_offsets.begin(), row_offsets.end(), target);
+                std::size_t row = std::size_t(it - row_offsets.begin()) - 1;
+                if (row > to_return.back() && row < height)
+                    to_return.push_back(row);
+            }
+            to_return.push_back(height);
+            return to_return;
+        }
+
+        template <typename F>
+        void parallel_rows(thread_pool<std::function<void()>>& pool, F f) const {
+            std::vector<std::size_t> bounds = balanced_rows();
+            parallel_for(pool, bounds.size() - 1, [&](std::size_t i) { f(bounds[i], bounds[i + 1]); });
+        }
+
+        void multiply_rows(const T* x, T* y, std::size_t first, std::size_t last) const {
+            for (std::size_t r = first; r < last; ++r) {
+                T sum = T(0);
+                for (std::size_t i = row_offsets[r]; i < row_offsets[r + 1]; ++i)
+                    sum = sum + values[i] * x[columns[i]];
+                y[r] = sum;
+            }
+        }
+
+        // Row r of the result is the sum of the rows of b picked by row r's non-zeros
+        void multiply_rows(const T* b, std::size_t m, T* c, std::size_t first, std::size_t last) const {
+            for (std::size_t r = first; r < last; ++r) {
+                T* cr = c + r * m;
+                std::fill_n(cr, m, T(0));
+                for (std::size_t i = row_offsets[r]; i < row_offsets[r + 1]; ++i) {
+                    const T* br = b + columns[i] * m;
+                    T v = values[i];
+                    for (std::size_t j = 0; j < m; ++j)
+                        cr[j] = cr[j] + v * br[j];
+                }
+            }
+        }
+
+        void check_vector(std::span<const T> x, std::span<T> y) const {
+            if (x.size() != width || y.size() != height)
+                throw std::invalid_argument("Vector sizes do not match the sparse matrix");
+        }
+
+        template <typename C>
+        void check_product(const matrix<T, C>& b) const {
+            if (b.get_height() != width)
+                throw invalid_matrix_dimensions(*this, b, '*');
+        }
+    public:
+        using value_type = T;
+
+        sparse_matrix() = default;
+        sparse_matrix(std::size_t _width, std::size_t _height) :
+                width(_width), height(_height), row_offsets(_height + 1, 0) {}
+
+        // Counting sort by row, then by column within each row; duplicates are summed and zeros dropped
+        explicit sparse_matrix(const coo_matrix<T>& coo) : sparse_matrix(coo.width, coo.height) {
+            std::vector<std::size_t> starts(height + 1, 0);
+            for (const auto& e : coo.entries)
+                ++starts[e.y + 1];
+            for (std::size_t r = 0; r < height; ++r)
+                starts[r + 1] += starts[r];
+            std::vector<std::size_t> order(coo.entries.size());
+            std::vector<std::size_t> next(starts.begin(), starts.end() - 1);
+            for (std::size_t i = 0; i < coo.entries.size(); ++i)
+                order[next[coo.entries[i].y]++] = i;
+
+            columns.reserve(coo.entries.size());
+            values.reserve(coo.entries.size());
+            for (std::size_t r = 0; r < height; ++r) {
+                auto first = order.begin() + std::ptrdiff_t(starts[r]);
+                auto last = order.begin() + std::ptrdiff_t(starts[r + 1]);
+                std::stable_sort(first, last, [&](std::size_t a, std::size_t b) {
+                    return coo.entries[a].x < coo.entries[b].x;
+                });
+                for (auto it = first; it != last;) {
+                    std::size_t x = coo.entries[*it].x;
+                    T sum = coo.entries[*it].value;
+                    for (++it; it != last && coo.entries[*it].x == x; ++it)
+                        sum = sum + coo.entries[*it].value;
+                    if (sum != T(0)) {
+                        columns.push_back(x);
+                        values.push_back(sum);
+                    }
+                }
+                row_offsets[r + 1] = columns.size();
+            }
+        }
+
+        template <typename C>
+        explicit sparse_matrix(const matrix<T, C>& dense) : sparse_matrix(dense.get_width(), dense.get_height()) {
+            const auto& raw = dense.get_raw();
+            for (std::size_t r = 0; r < height; ++r) {
+                for (std::size_t c = 0; c < width; ++c) {
+                    if (raw[r * width + c] != T(0)) {
+                        columns.push_back(c);
+                        values.push_back(raw[r * width + c]);
+                    }
+                }
+                row_offsets[r + 1] = columns.size();
+            }
+        }
+
+        [[nodiscard]] std::size_t get_width() const { return width; }
+        [[nodiscard]] std::size_t get_height() const { return height; }
+        [[nodiscard]] std::size_t non_zeros() const { return values.size(); }
+
+        [[nodiscard]] std::span<const std::size_t> get_row_offsets() const { return row_offsets; }
+        [[nodiscard]] std::span<const std::size_t> get_columns() const { return columns; }
+        [[nodiscard]] std::span<const T> get_values() const { return values; }
+
+        // Value at column x of row y, zero when not stored
+        [[nodiscard]] T at(std::size_t x, std::size_t y) const {
+            if (x >= width || y >= height)
+                throw std::out_of_range("Index out of range");
+            auto first = columns.begin() + std::ptrdiff_t(row_offsets[y]);
+            auto last = columns.begin() + std::ptrdiff_t(row_offsets[y + 1]);
+            auto it = std::lower_bound(first, last, x);
+            return it != last && *it == x ? values[std::size_t(it - columns.begin())] : T(0);
+        }
+
+        // Writes the dense row-major form
+        void assign_to(T* dest) const {
+            std::fill_n(dest, width * height, T(0));
+            for (std::size_t r = 0; r < height; ++r)
+                for (std::size_t i = row_offsets[r]; i < row_offsets[r + 1]; ++i)
+                    dest[r * width + columns[i]] = values[i];
+        }
+
+        [[nodiscard]] matrix<T> to_dense() const { return matrix<T>(*this); }
+
+        [[nodiscard]] sparse_matrix transposed() const {
+            sparse_matrix to_return(height, width);
+            for (std::size_t c : columns)
+                ++to_return.row_offsets[c + 1];
+            for (std::size_t r = 0; r < width; ++r)
+                to_return.row_offsets[r + 1] += to_return.row_offsets[r];
+            to_return.columns.resize(values.size());
+            to_return.values.resize(values.size());
+            std::vector<std::size_t> next(to_return.row_offsets.begin(), to_return.row_offsets.end() - 1);
+            for (std::size_t r = 0; r < height; ++r) {
+                for (std::size_t i = row_offsets[r]; i < row_offsets[r + 1]; ++i) {
+                    std::size_t position = next[columns[i]]++;
+                    to_return.columns[position] = r;
+                    to_return.values[position] = values[i];
+                }
+            }
+            return to_return;
+        }
+
+        // y = A x
+        void multiply(std::span<const T> x, std::span<T> y) const {
+            check_vector(x, y);
+            multiply_rows(x.data(), y.data(), 0, height);
+        }
+
+        // As above, with rows split over pool so every task gets about the same number of non-zeros
+        void multiply(std::span<const T> x, std::span<T> y, thread_pool<std::function<void()>>& pool) const {
+            check_vector(x, y);
+            parallel_rows(pool, [&](std::size_t first, std::size_t last) {
+                multiply_rows(x.data(), y.data(), first, last);
+            });
+        }
+
+        [[nodiscard]] std::vector<T> operator*(std::span<const T> x) const {
+            std::vector<T> to_return(height);
+            multiply(x, to_return);
+            return to_return;
+        }
+
+        [[nodiscard]] std::vector<T> operator*(const std::vector<T>& x) const { return *this * std::span<const T>(x); }
+
+        // A B for a dense B
+        template <typename C>
+        [[nodiscard]] matrix<T> multiply(const matrix<T, C>& b) const {
+            check_product(b);
+            matrix<T> to_return(long(b.get_width()), std::size_t(b.get_width() * height));
+            multiply_rows(std::data(b.get_raw()), b.get_width(), std::data(to_return.get_raw()), 0, height);
+            return to_return;
+        }
+
+        template <typename C>
+        [[nodiscard]] matrix<T> multiply(const matrix<T, C>& b, thread_pool<std::function<void()>>& pool) const {
+            check_product(b);
+            matrix<T> to_return(long(b.get_width()), std::size_t(b.get_width() * height));
+            parallel_rows(pool, [&](std::size_t first, std::size_t last) {
+                multiply_rows(std::data(b.get_raw()), b.get_width(), std::data(to_return.get_raw()), first, last);
+            });
+            return to_return;
+        }
+
+        template <typename C>
+        [[nodiscard]] matrix<T> operator*(const matrix<T, C>& b) const {
+            return multiply(b);
+        }
+    };
+} // namespace ox
+
+#endif // OXLIB__SPARSE_MATRIX_H
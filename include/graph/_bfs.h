@@ -0,0 +1,242 @@
+#ifndef OX_LIB__BFS_H
+#define OX_LIB__BFS_H
+
+#include <concepts>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+#include <unordered_set>
+#include <unordered_map>
+#include <utility>
+#include <ox/grid.h>
+
+namespace ox {
+    class bfs_bitmap {
+        std::vector<std::uint64_t> words;
+    public:
+        explicit bfs_bitmap(std::size_t size = 0) : words((size + 63) / 64) {}
+
+        [[nodiscard]] bool test(long i) const { return (words[i >> 6] >> (i & 63)) & 1; }
+
+        void set(long i) { words[i >> 6] |= std::uint64_t{1} << (i & 63); }
+
+        bool test_and_set(long i) {
+            auto mask = std::uint64_t{1} << (i & 63);
+            bool was_set = words[i >> 6] & mask;
+            words[i >> 6] |= mask;
+            return was_set;
+        }
+
+        [[nodiscard]] std::uint64_t word(std::size_t index) const { return words[index]; }
+
+        [[nodiscard]] std::size_t word_count() const { return words.size(); }
+
+        void clear() { std::ranges::fill(words, 0); }
+    };
+
+    /*
+     * Breadth-first search over nodes numbered 0..node_count-1.
+     * get_neighbours(node) returns a range of node ids; negative ids are skipped so fixed-size
+     * neighbour arrays can be padded with -1.
+     *
+     * With direction_optimizing() the search switches to bottom-up steps (every unvisited node looks for a
+     * parent in the frontier) while the frontier is large, which only gives correct results when the
+     * neighbour relation is symmetric.
+     */
+    template <typename NeighbourFunction>
+    class bfs {
+    public:
+        constexpr static long alpha = 14;
+        constexpr static long beta = 24;
+    private:
+        long node_count;
+        NeighbourFunction get_neighbours;
+        bool optimize_direction = false;
+
+        bfs_bitmap visited;
+        bfs_bitmap in_frontier;
+        std::vector<long> frontier;
+        std::vector<long> next_frontier;
+
+        void top_down_step() {
+            for (long current : frontier) {
+                for (long neighbour : std::invoke(get_neighbours, current)) {
+                    if (neighbour >= 0 && !visited.test_and_set(neighbour))
+                        next_frontier.push_back(neighbour);
+                }
+            }
+        }
+
+        void bottom_up_step() {
+            in_frontier.clear();
+            for (long current : frontier)
+                in_frontier.set(current);
+
+            for (std::size_t w = 0; w < visited.word_count(); ++w) {
+                if (~visited.word(w) == 0)
+                    continue;
+                long last = std::min(long(w + 1) * 64, node_count);
+                for (long current = long(w) * 64; current < last; ++current) {
+                    if (visited.test(current))
+                        continue;
+                    for (long neighbour : std::invoke(get_neighbours, current)) {
+                        if (neighbour >= 0 && in_frontier.test(neighbour)) {
+                            next_frontier.push_back(current);
+                            break;
+                        }
+                    }
+                }
+            }
+            for (long current : next_frontier)
+                visited.set(current);
+        }
+
+        template <typename LayerFunction>
+        static bool call_layer(LayerFunction& on_layer, long depth, std::span<const long> layer) {
+            if constexpr (std::same_as<std::invoke_result_t<LayerFunction&, long, std::span<const long>>, bool>) {
+                return std::invoke(on_layer, depth, layer);
+            } else {
+                std::invoke(on_layer, depth, layer);
+                return true;
+            }
+        }
+    public:
+        bfs(long _node_count, NeighbourFunction _get_neighbours) :
+                node_count(_node_count),
+                get_neighbours(std::move(_get_neighbours)),
+                visited(_node_count),
+                in_frontier(_node_count) {}
+
+        void direction_optimizing() { optimize_direction = true; }
+
+        /*
+         * Runs the search from start, calling on_layer(depth, nodes) once per depth with every node first reached
+         * at that depth. Returning false from on_layer stops the search.
+         */
+        template <typename LayerFunction>
+        void run(long start, LayerFunction on_layer) {
+            visited.clear();
+            frontier.assign(1, start);
+            visited.set(start);
+            long unvisited = node_count - 1;
+            bool bottom_up = false;
+
+            for (long depth = 0; !frontier.empty(); ++depth) {
+                if (!call_layer(on_layer, depth, frontier))
+                    return;
+                if (optimize_direction) {
+                    if (!bottom_up && long(frontier.size()) * alpha > unvisited)
+                        bottom_up = true;
+                    else if (bottom_up && long(frontier.size()) * beta < node_count)
+                        bottom_up = false;
+                }
+                next_frontier.clear();
+                if (bottom_up)
+                    bottom_up_step();
+                else
+                    top_down_step();
+                unvisited -= long(next_frontier.size());
+                std::swap(frontier, next_frontier);
+            }
+        }
+
+        // Depth of every node from start, -1 for unreachable nodes
+        std::vector<long> distances(long start) {
+            std::vector<long> to_return(node_count, -1);
+            run(start, [&to_return](long depth, std::span<const long> layer) {
+                for (long node : layer)
+                    to_return[node] = depth;
+            });
+            return to_return;
+        }
+
+        bool reachable(long from, long to) {
+            bool found = false;
+            run(from, [&found, to](long, std::span<const long> layer) {
+                found = std::ranges::find(layer, to) != layer.end();
+                return !found;
+            });
+            return found;
+        }
+
+        // Nodes reached by the last run
+        [[nodiscard]] const bfs_bitmap& get_visited() const { return visited; }
+    };
+
+    /*
+     * Layered breadth-first search for node types that are not dense ids, with a hashed visited set.
+     * on_layer(depth, nodes) follows the same contract as bfs::run.
+     */
+    template <typename Node, typename NeighbourFunction, typename LayerFunction, typename Hash = std::hash<Node>>
+    void bfs_layers(Node start, NeighbourFunction get_neighbours, LayerFunction on_layer, Hash = Hash()) {
+        std::unordered_set<Node, Hash> visited{start};
+        std::vector<Node> frontier{std::move(start)};
+        std::vector<Node> next_frontier;
+
+        for (long depth = 0; !frontier.empty(); ++depth) {
+            std::span<const Node> layer = frontier;
+            if constexpr (std::same_as<std::invoke_result_t<LayerFunction&, long, std::span<const Node>>, bool>) {
+                if (!std::invoke(on_layer, depth, layer))
+                    return;
+            } else {
+                std::invoke(on_layer, depth, layer);
+            }
+            next_frontier.clear();
+            for (const Node& current : frontier) {
+                for (auto&& neighbour : std::invoke(get_neighbours, current)) {
+                    if (visited.insert(neighbour).second)
+                        next_frontier.push_back(neighbour);
+                }
+            }
+            std::swap(frontier, next_frontier);
+        }
+    }
+
+    template <typename Node, typename NeighbourFunction, typename Hash = std::hash<Node>>
+    std::unordered_map<Node, long, Hash> bfs_distances(Node start, NeighbourFunction get_neighbours, Hash = Hash()) {
+        std::unordered_map<Node, long, Hash> to_return;
+        bfs_layers(
+                std::move(start),
+                std::move(get_neighbours),
+                [&to_return](long depth, std::span<const Node> layer) {
+                    for (const Node& node : layer)
+                        to_return.emplace(node, depth);
+                },
+                Hash());
+        return to_return;
+    }
+
+    // Flat-index neighbour function over the passable cells of a grid, for use with ox::bfs
+    template <typename T, typename Container, std::predicate<const T&> Passable>
+    auto grid_neighbours(const grid<T, Container>& source, Passable passable) {
+        return [&source, passable](long index) {
+            std::array<long, 4> neighbours{-1, -1, -1, -1};
+            if (!std::invoke(passable, source.get_raw()[index]))
+                return neighbours;
+            neighbours = source.cardinal_neighbour_indices(index);
+            for (long& n : neighbours) {
+                if (n >= 0 && !std::invoke(passable, source.get_raw()[n]))
+                    n = -1;
+            }
+            return neighbours;
+        };
+    }
+
+    // Steps from the flat index start to every passable cell, -1 for unreachable cells
+    template <typename T, typename Container, std::predicate<const T&> Passable>
+    grid<long> bfs_distance_map(const grid<T, Container>& source, long start, Passable passable,
+                                bool direction_optimizing = false) {
+        bfs search(long(source.get_size()), grid_neighbours(source, std::move(passable)));
+        if (direction_optimizing)
+            search.direction_optimizing();
+        grid<long> to_return(long(source.get_width()), source.get_size(), -1l);
+        search.run(start, [&to_return](long depth, std::span<const long> layer) {
+            for (long index : layer)
+                to_return.get_raw()[index] = depth;
+        });
+        return to_return;
+    }
+} // namespace ox
+
+#endif // OX_LIB__BFS_H
@@ -0,0 +1,152 @@
+#ifndef OX_LIB__GRID_CONTRACTION_H
+#define OX_LIB__GRID_CONTRACTION_H
+
+#include <concepts>
+#include <vector>
+#include <span>
+#include <utility>
+#include <initializer_list>
+#include <algorithm>
+#include <ox/grid.h>
+
+namespace ox {
+    /*
+     * Weighted graph of the junctions and dead-ends of a grid.
+     * Every run of degree-2 cells between two such nodes becomes a single edge weighted by its length,
+     * so a maze with long corridors can be searched one corridor at a time rather than one cell at a time.
+     *
+     * Nodes are numbered 0..size()-1; cell() and node_of() translate to and from flat grid indices.
+     */
+    class contracted_graph {
+    public:
+        using NodeType = long;
+        using Cost = long;
+        using edge = std::pair<NodeType, Cost>;
+    private:
+        std::vector<long> cells;
+        std::vector<long> nodes;
+        std::vector<std::vector<edge>> edges;
+
+        template <typename, typename, typename>
+        friend class contracted_graph_builder;
+
+        long longest_path_imp(long current, long to, std::vector<char>& visited) const {
+            if (current == to)
+                return 0;
+            visited[current] = true;
+            long best = -1;
+            for (auto [next, cost] : edges[current]) {
+                if (visited[next])
+                    continue;
+                long rest = longest_path_imp(next, to, visited);
+                if (rest >= 0)
+                    best = std::max(best, rest + cost);
+            }
+            visited[current] = false;
+            return best;
+        }
+    public:
+        [[nodiscard]] std::size_t size() const { return cells.size(); }
+
+        // Flat grid index of a node
+        [[nodiscard]] long cell(NodeType node) const { return cells[node]; }
+
+        // Node at a flat grid index, or -1 if that cell was contracted into a corridor
+        [[nodiscard]] NodeType node_of(long cell) const { return nodes[cell]; }
+
+        [[nodiscard]] std::span<const edge> neighbours(NodeType node) const { return edges[node]; }
+
+        // Neighbour function in the shape expected by ox::dikstra_solver and ox::dikstra
+        [[nodiscard]] auto neighbour_function() const {
+            return [this](NodeType node) { return neighbours(node); };
+        }
+
+        // Length of the longest simple path between two nodes, or -1 if to is unreachable
+        [[nodiscard]] long longest_path(NodeType from, NodeType to) const {
+            std::vector<char> visited(size());
+            return longest_path_imp(from, to, visited);
+        }
+    };
+
+    template <typename T, typename Container, typename Passable>
+    class contracted_graph_builder {
+        const grid<T, Container>& source;
+        Passable passable;
+        contracted_graph result;
+
+        bool open(long cell) const { return cell >= 0 && std::invoke(passable, source.get_raw()[cell]); }
+
+        int degree(long cell) const {
+            auto neighbours = source.cardinal_neighbour_indices(cell);
+            return int(std::ranges::count_if(neighbours, [this](long n) { return open(n); }));
+        }
+
+        void add_node(long cell) {
+            if (result.nodes[cell] >= 0)
+                return;
+            result.nodes[cell] = long(result.cells.size());
+            result.cells.push_back(cell);
+        }
+
+        // Walks a corridor starting with the step from -> next until it reaches another node
+        void follow(long from_node, long from, long next) {
+            long previous = from;
+            long current = next;
+            long length = 1;
+            while (result.nodes[current] < 0) {
+                long step = -1;
+                for (long n : source.cardinal_neighbour_indices(current)) {
+                    if (n != previous && open(n)) {
+                        step = n;
+                        break;
+                    }
+                }
+                if (step < 0)
+                    return;
+                previous = current;
+                current = step;
+                ++length;
+            }
+            if (result.nodes[current] != from_node)
+                result.edges[from_node].emplace_back(result.nodes[current], length);
+        }
+    public:
+        contracted_graph_builder(const grid<T, Container>& _source, Passable _passable) :
+                source(_source), passable(std::move(_passable)) {
+            result.nodes.assign(source.get_size(), -1);
+        }
+
+        contracted_graph build(std::initializer_list<long> keep) && {
+            long size = long(source.get_size());
+            for (long cell : keep)
+                if (open(cell))
+                    add_node(cell);
+            for (long cell = 0; cell < size; ++cell)
+                if (open(cell) && degree(cell) != 2)
+                    add_node(cell);
+
+            result.edges.resize(result.cells.size());
+            for (long node = 0; node < long(result.cells.size()); ++node) {
+                long cell = result.cells[node];
+                for (long n : source.cardinal_neighbour_indices(cell)) {
+                    if (open(n))
+                        follow(node, cell, n);
+                }
+            }
+            return std::move(result);
+        }
+    };
+
+    /*
+     * Contracts a grid into a contracted_graph.
+     * passable(cell) decides which cells can be walked on; cells listed in keep (flat indices, e.g. start and end)
+     * are kept as nodes even when they sit in the middle of a corridor.
+     */
+    template <typename T, typename Container, std::predicate<const T&> Passable>
+    contracted_graph contract_grid(const grid<T, Container>& source, Passable passable,
+                                   std::initializer_list<long> keep = {}) {
+        return contracted_graph_builder<T, Container, Passable>(source, std::move(passable)).build(keep);
+    }
+} // namespace ox
+
+#endif // OX_LIB__GRID_CONTRACTION_H
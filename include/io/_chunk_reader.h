@@ -0,0 +1,223 @@
+#ifndef OXLIB_IO_CHUNK_READER_H
+#define OXLIB_IO_CHUNK_READER_H
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "../ranges/_split_lines_view.h"
+#include "_file.h"
+
+namespace ox {
+    /*
+     * Streams a file descriptor of any size or kind (files, pipes, sockets) as blocks of whole records.
+     * A background thread reads fixed size chunks into a ring of buffers ahead of the consumer, so reading overlaps
+     * with whatever is done with the previous blocks. Each block returned by next() ends with the delimiter, except
+     * possibly the last one of the input; a record spanning two chunks is returned as a block of its own, stitched
+     * together in a separate buffer. A block stays valid until the following call to next().
+     *
+     * for (std::string_view block : reader)       whole records, straight from the ring buffers
+     * for (std::string_view line : reader.lines())
+     *
+     * The reader takes over fd from its current position (data already buffered by a FILE* is not seen) but does not
+     * close it. Read errors are thrown as errno, like ox::file, by the next() reaching them.
+     */
+    class chunk_reader {
+        struct chunk {
+            std::vector<char> data;
+            std::size_t size = 0;
+            bool filled = false;
+            bool last = false;
+            int error = 0;
+        };
+
+        int fd;
+        char delimiter;
+        std::vector<chunk> ring;
+        std::mutex mutex;
+        std::condition_variable changed;
+        bool stopping = false;
+
+        // consumer side
+        std::size_t current = 0;
+        bool holding = false;
+        bool finished = false;
+        std::string_view rest;
+        std::string carry;
+        std::string stitched;
+
+        // declared last: started once everything above exists, and joined before any of it is destroyed
+        std::jthread producer;
+
+        void produce() {
+            for (std::size_t i = 0;; i = (i + 1) % ring.size()) {
+                chunk& c = ring[i];
+                {
+                    std::unique_lock lock(mutex);
+                    changed.wait(lock, [&] { return !c.filled || stopping; });
+                    if (stopping)
+                        return;
+                }
+                std::size_t used = 0;
+                int error = 0;
+                while (used < c.data.size()) {
+                    ssize_t count = ::read(fd, c.data.data() + used, c.data.size() - used);
+                    if (count < 0) {
+                        if (errno == EINTR)
+                            continue;
+                        error = errno;
+                        break;
+                    }
+                    if (count == 0)
+                        break;
+                    used += std::size_t(count);
+                }
+                bool last = used < c.data.size();
+                {
+                    std::lock_guard lock(mutex);
+                    c.size = used;
+                    c.error = error;
+                    c.last = last;
+                    c.filled = true;
+                }
+                changed.notify_all();
+                if (last)
+                    return;
+            }
+        }
+
+        chunk& acquire() {
+            std::unique_lock lock(mutex);
+            changed.wait(lock, [&] { return ring[current].filled; });
+            holding = true;
+            return ring[current];
+        }
+
+        void release() {
+            {
+                std::lock_guard lock(mutex);
+                ring[current].filled = false;
+            }
+            changed.notify_all();
+            current = (current + 1) % ring.size();
+            holding = false;
+        }
+
+        std::string_view stitch() {
+            stitched.swap(carry);
+            carry.clear();
+            return stitched;
+        }
+    public:
+        // Reads fd in chunk_size pieces, up to buffers of them ahead of the consumer
+        explicit chunk_reader(int _fd, std::size_t chunk_size = 1 << 20, std::size_t buffers = 2,
+                              char _delimiter = '\n') :
+                fd(_fd), delimiter(_delimiter), ring(std::max<std::size_t>(buffers, 1)) {
+            for (chunk& c : ring)
+                c.data.resize(std::max<std::size_t>(chunk_size, 1));
+            producer = std::jthread(&chunk_reader::produce, this);
+        }
+
+        explicit chunk_reader(const file& f, std::size_t chunk_size = 1 << 20, std::size_t buffers = 2,
+                              char _delimiter = '\n') :
+                chunk_reader(fileno(f), chunk_size, buffers, _delimiter) {}
+
+        chunk_reader(const chunk_reader&) = delete;
+        chunk_reader& operator=(const chunk_reader&) = delete;
+
+        // A producer blocked in read() on a pipe is only joined once that read returns
+        ~chunk_reader() {
+            {
+                std::lock_guard lock(mutex);
+                stopping = true;
+            }
+            changed.notify_all();
+        }
+
+        // The next block of whole records, or nullopt at the end of the input
+        std::optional<std::string_view> next() {
+            while (true) {
+                if (holding && rest.empty())
+                    release();
+                if (!rest.empty()) {
+                    std::size_t last = rest.rfind(delimiter);
+                    if (last == std::string_view::npos) {
+                        carry.assign(rest);
+                        rest = {};
+                        continue;
+                    }
+                    std::string_view block = rest.substr(0, last + 1);
+                    carry.assign(rest.substr(last + 1));
+                    rest = {};
+                    return block;
+                }
+                if (finished)
+                    return carry.empty() ? std::nullopt : std::optional(stitch());
+
+                chunk& c = acquire();
+                if (c.error) {
+                    int error = c.error;
+                    finished = true;
+                    release();
+                    throw error;
+                }
+                finished = c.last;
+                std::string_view data(c.data.data(), c.size);
+                if (carry.empty()) {
+                    rest = data;
+                    continue;
+                }
+                std::size_t first = data.find(delimiter);
+                if (first == std::string_view::npos) {
+                    carry.append(data);
+                    continue;
+                }
+                carry.append(data.substr(0, first + 1));
+                rest = data.substr(first + 1);
+                return stitch();
+            }
+        }
+
+        class iterator {
+            chunk_reader* reader = nullptr;
+            std::optional<std::string_view> block;
+        public:
+            using value_type = std::string_view;
+            using difference_type = std::ptrdiff_t;
+
+            iterator() = default;
+            explicit iterator(chunk_reader& _reader) : reader(&_reader), block(_reader.next()) {}
+
+            std::string_view operator*() const { return *block; }
+            iterator& operator++() {
+                block = reader->next();
+                return *this;
+            }
+            void operator++(int) { ++*this; }
+
+            friend bool operator==(const iterator& i, std::default_sentinel_t) { return !i.block; }
+        };
+
+        // Single pass: begin() starts consuming blocks
+        iterator begin() { return iterator(*this); }
+        std::default_sentinel_t end() { return {}; }
+
+        // The lines of every block, without "\n" or "\r\n"
+        auto lines() {
+            auto split = [](std::string_view block) { return block | ranges::views::split_lines; };
+            return *this | std::views::transform(split) | std::views::join;
+        }
+    };
+} // namespace ox
+
+#endif // OXLIB_IO_CHUNK_READER_H
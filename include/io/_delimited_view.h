@@ -0,0 +1,101 @@
+#ifndef OXLIB_IO_DELIMITED_VIEW_H
+#define OXLIB_IO_DELIMITED_VIEW_H
+
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+#include <string_view>
+
+namespace ox {
+    namespace details {
+        // Every char as a one character string, so a single character delimiter needs no storage of its own
+        inline constexpr auto single_chars = [] {
+            std::array<char, 256> to_return{};
+            for (std::size_t i = 0; i < to_return.size(); ++i)
+                to_return[i] = char(i);
+            return to_return;
+        }();
+    } // namespace details
+
+    enum class trailing_piece { kept, dropped };
+
+    /*
+     * The pieces of a buffer between occurrences of a delimiter, as string_views into the buffer: nothing is copied.
+     * With trailing_piece::dropped a delimiter at the very end closes the last piece instead of opening an empty one,
+     * as getline treats a final newline. An empty buffer has no pieces, and the delimiter must not be empty.
+     */
+    class delimited_view : public std::ranges::view_interface<delimited_view> {
+        std::string_view buffer;
+        std::string_view delimiter;
+        trailing_piece trailing = trailing_piece::kept;
+    public:
+        class iterator {
+            // start and end of the current piece; start is null past the last piece
+            const char* start = nullptr;
+            const char* stop = nullptr;
+            const char* end = nullptr;
+            std::string_view delimiter;
+            trailing_piece trailing = trailing_piece::kept;
+
+            void find_stop() {
+                std::size_t found = std::string_view(start, std::size_t(end - start)).find(delimiter);
+                stop = found == std::string_view::npos ? end : start + found;
+            }
+        public:
+            using value_type = std::string_view;
+            using difference_type = std::ptrdiff_t;
+            using iterator_concept = std::forward_iterator_tag;
+
+            iterator() = default;
+            iterator(const delimited_view& parent, bool at_end) :
+                    end(parent.buffer.data() + parent.buffer.size()),
+                    delimiter(parent.delimiter),
+                    trailing(parent.trailing) {
+                if (!at_end && !parent.buffer.empty()) {
+                    start = parent.buffer.data();
+                    find_stop();
+                }
+            }
+
+            std::string_view operator*() const { return {start, std::size_t(stop - start)}; }
+
+            iterator& operator++() {
+                if (stop == end) {
+                    start = nullptr;
+                    return *this;
+                }
+                start = stop + delimiter.size();
+                if (start == end && trailing == trailing_piece::dropped)
+                    start = nullptr;
+                else
+                    find_stop();
+                return *this;
+            }
+
+            iterator operator++(int) {
+                auto temp = *this;
+                ++*this;
+                return temp;
+            }
+
+            friend bool operator==(const iterator& x, const iterator& y) { return x.start == y.start; }
+        };
+
+        delimited_view() = default;
+        delimited_view(std::string_view _buffer, std::string_view _delimiter,
+                       trailing_piece _trailing = trailing_piece::kept) :
+                buffer(_buffer), delimiter(_delimiter), trailing(_trailing) {}
+        delimited_view(std::string_view _buffer, char _delimiter, trailing_piece _trailing = trailing_piece::kept) :
+                delimited_view(_buffer, {&details::single_chars[(unsigned char)_delimiter], 1}, _trailing) {}
+
+        [[nodiscard]] iterator begin() const { return {*this, false}; }
+        [[nodiscard]] iterator end() const { return {*this, true}; }
+    };
+} // namespace ox
+
+// The pieces point into the buffer, not into the view
+template <>
+inline constexpr bool std::ranges::enable_borrowed_range<ox::delimited_view> = true;
+
+#endif // OXLIB_IO_DELIMITED_VIEW_H
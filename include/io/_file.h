@@ -3,10 +3,21 @@
 
 #include <cstdio>
 #include <unistd.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <climits>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string>
 #include <string_view>
 #include <filesystem>
 #include <fstream>
 #include <iterator>
+#include <type_traits>
+#include "../ox/bytes.h"
 
 #define OX_THROW_ON_FAILURE if(failure) throw errno;
 
@@ -121,14 +132,130 @@ namespace ox {
             return fgetc(cfile);
         }
 
+        // Up to max - 1 characters, stopping after a newline, as fgets
         std::string gets(int max) {
-            std::string to_return;
-            to_return.reserve(max);
-            char* success = fgets(to_return.data(), max, cfile);
+            std::string to_return(std::size_t(std::max(max, 1)), '\0');
+            char* success = fgets(to_return.data(), int(to_return.size()), cfile);
             if (!success) throw errno;
+            to_return.resize(std::strlen(to_return.data()));
             return to_return;
         }
 
+        /*
+         * The next line, without its newline, into line: once line has grown to the longest line read, no further
+         * allocation happens. False, with line empty, at the end of the file.
+         */
+        bool read_line(std::string& line) {
+            line.clear();
+            char chunk[256];
+            while (fgets(chunk, sizeof(chunk), cfile)) {
+                std::size_t length = std::strlen(chunk);
+                if (length && chunk[length - 1] == '\n') {
+                    line.append(chunk, length - 1);
+                    return true;
+                }
+                line.append(chunk, length);
+            }
+            if (error()) throw errno;
+            return !line.empty();
+        }
+
+        // A line, or a piece of one, read into a caller buffer; complete once its newline (or the end of file) is read
+        struct line_piece {
+            std::string_view text;
+            bool complete;
+        };
+
+        /*
+         * The next line, without its newline, read into buffer. A line longer than buffer.size() - 1 is returned in
+         * pieces, all but the last one incomplete. A line that exactly fills the buffer is complete, its newline
+         * consumed, rather than followed by an empty piece.
+         */
+        std::optional<line_piece> read_line(std::span<char> buffer) {
+            if (buffer.size() < 2)
+                return std::nullopt;
+            int size = int(std::min<std::size_t>(buffer.size(), INT_MAX));
+            if (!fgets(buffer.data(), size, cfile)) {
+                if (error()) throw errno;
+                return std::nullopt;
+            }
+            std::string_view text(buffer.data(), std::strlen(buffer.data()));
+            if (text.ends_with('\n')) {
+                text.remove_suffix(1);
+                return line_piece{text, true};
+            }
+            if (text.size() + 1 < std::size_t(size))
+                return line_piece{text, true};
+            // the buffer is full: the line goes on unless a newline or the end of file comes next
+            int next = std::getc(cfile);
+            if (next == EOF) {
+                if (error()) throw errno;
+                return line_piece{text, true};
+            }
+            if (next != '\n')
+                std::ungetc(next, cfile);
+            return line_piece{text, next == '\n'};
+        }
+
+        // Everything from the current position to the end; a regular file is read with a single read of its size
+        std::string read_all() {
+            std::string to_return;
+            struct stat info {};
+            if (fstat(fileno(cfile), &info) == 0 && S_ISREG(info.st_mode)) {
+                long position = ftell(cfile);
+                std::size_t remaining =
+                        position < 0 || position > info.st_size ? 0 : std::size_t(info.st_size - position);
+                to_return.resize(remaining);
+                to_return.resize(fread(to_return.data(), 1, remaining, cfile));
+                if (error()) throw errno;
+                return to_return;
+            }
+            // pipes and other streams of unknown size
+            while (true) {
+                std::size_t used = to_return.size();
+                std::size_t room = std::max<std::size_t>(used, 1 << 16);
+                to_return.resize(used + room);
+                to_return.resize(used + fread(to_return.data() + used, 1, room, cfile));
+                if (error()) throw errno;
+                if (to_return.size() < used + room)
+                    break;
+            }
+            return to_return;
+        }
+
+        /*
+         * Reads up to values.size() values stored in order in the file, converting them to the native byte order;
+         * the result is the number of complete values read.
+         */
+        template <typename T>
+        requires (!std::is_const_v<T>) && std::is_trivially_copyable_v<T> && endianable<T>
+        std::size_t read(std::span<T> values, std::endian order = std::endian::native) {
+            std::size_t count = fread(values.data(), sizeof(T), values.size(), cfile);
+            if (order != std::endian::native)
+                ox::bswap(values.data(), int(count));
+            return count;
+        }
+
+        // Writes values in the given byte order; the result is the number of values written
+        template <typename T>
+        requires std::is_trivially_copyable_v<T> && endianable<std::remove_const_t<T>>
+        std::size_t write(std::span<T> values, std::endian order = std::endian::native) {
+            if (order == std::endian::native)
+                return fwrite(values.data(), sizeof(T), values.size(), cfile);
+            // swapped through a small buffer so values are left untouched and nothing is allocated
+            std::array<std::remove_const_t<T>, std::max<std::size_t>(4096 / sizeof(T), 1)> swapped;
+            std::size_t written = 0;
+            while (written < values.size()) {
+                std::size_t batch = std::min(swapped.size(), values.size() - written);
+                ox::bswap_copy(values.data() + written, swapped.data(), batch);
+                std::size_t done = fwrite(swapped.data(), sizeof(T), batch, cfile);
+                written += done;
+                if (done < batch)
+                    break;
+            }
+            return written;
+        }
+
         void putc(int character) {
             int result = fputc(character, cfile);
             if (result == EOF) throw errno;
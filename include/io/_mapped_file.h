@@ -0,0 +1,143 @@
+#ifndef OXLIB_IO_MAPPED_FILE_H
+#define OXLIB_IO_MAPPED_FILE_H
+
+#include <cerrno>
+#include <cstddef>
+#include <filesystem>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../ranges/_split_lines_view.h"
+#include "_delimited_view.h"
+
+namespace ox {
+    /*
+     * The whole content of a file as one read-only buffer. Regular files are memory mapped and read on demand by the
+     * kernel, hinted for sequential access; anything that cannot be mapped (pipes, sockets, terminals) is read into
+     * memory instead. Either way lines(), split() and records() hand out string_views into the buffer, so iterating
+     * copies nothing. Failures throw errno, like ox::file.
+     */
+    class mapped_file {
+        const char* contents = nullptr;
+        std::size_t length = 0;
+        bool mapped = false;
+        std::vector<char> buffer;
+
+        void load(int fd) {
+            struct stat info {};
+            if (fstat(fd, &info) != 0)
+                throw errno;
+            if (S_ISREG(info.st_mode) && info.st_size > 0) {
+                void* address = mmap(nullptr, std::size_t(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                if (address != MAP_FAILED) {
+                    contents = static_cast<const char*>(address);
+                    length = std::size_t(info.st_size);
+                    mapped = true;
+                    advise(address);
+                    return;
+                }
+            }
+            read_all(fd);
+        }
+
+        void advise(void* address) const {
+            madvise(address, length, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+            madvise(address, length, MADV_HUGEPAGE);
+#endif
+        }
+
+        void read_all(int fd) {
+            std::size_t used = 0;
+            buffer.resize(1 << 16);
+            while (true) {
+                if (used == buffer.size())
+                    buffer.resize(2 * buffer.size());
+                ssize_t count = ::read(fd, buffer.data() + used, buffer.size() - used);
+                if (count < 0) {
+                    if (errno == EINTR)
+                        continue;
+                    throw errno;
+                }
+                if (count == 0)
+                    break;
+                used += std::size_t(count);
+            }
+            buffer.resize(used);
+            buffer.shrink_to_fit();
+            contents = buffer.data();
+            length = used;
+        }
+
+        void release() {
+            if (mapped)
+                munmap(const_cast<char*>(contents), length);
+        }
+    public:
+        explicit mapped_file(const std::filesystem::path& filepath) {
+            int fd = ::open(filepath.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0)
+                throw errno;
+            try {
+                load(fd);
+            } catch (...) {
+                ::close(fd);
+                throw;
+            }
+            ::close(fd);
+        }
+
+        // The whole of fd if it is a regular file, what is left to read from it otherwise; fd stays open
+        explicit mapped_file(int fd) { load(fd); }
+
+        mapped_file(const mapped_file& other) = delete;
+        mapped_file& operator=(const mapped_file& other) = delete;
+
+        mapped_file(mapped_file&& other) noexcept :
+                contents{other.contents}, length{other.length}, mapped{other.mapped}, buffer{std::move(other.buffer)} {
+            other.contents = nullptr;
+            other.length = 0;
+            other.mapped = false;
+        }
+        mapped_file& operator=(mapped_file&& other) noexcept {
+            release();
+            contents = std::exchange(other.contents, nullptr);
+            length = std::exchange(other.length, 0);
+            mapped = std::exchange(other.mapped, false);
+            buffer = std::move(other.buffer);
+            return *this;
+        }
+
+        ~mapped_file() { release(); }
+
+        [[nodiscard]] const char* data() const noexcept { return contents; }
+        [[nodiscard]] std::size_t size() const noexcept { return length; }
+        [[nodiscard]] bool empty() const noexcept { return length == 0; }
+        // Whether the content is mapped rather than read into memory
+        [[nodiscard]] bool is_mapped() const noexcept { return mapped; }
+
+        [[nodiscard]] std::string_view view() const noexcept { return {contents, length}; }
+        [[nodiscard]] std::span<const std::byte> bytes() const noexcept {
+            return {reinterpret_cast<const std::byte*>(contents), length};
+        }
+        operator std::string_view() const noexcept { return view(); }
+
+        // Lines without their "\n" or "\r\n"; a final '\n' does not start an empty line
+        [[nodiscard]] ranges::split_lines_view lines() const { return view() | ranges::views::split_lines; }
+        // Every piece between separators, including empty ones and the one after a final separator
+        [[nodiscard]] ranges::split_lines_view split(char separator) const {
+            return ranges::views::split_on(view(), separator);
+        }
+        // Records closed or separated by delimiter, which must outlive the view
+        [[nodiscard]] delimited_view records(std::string_view delimiter) const {
+            return {view(), delimiter, trailing_piece::dropped};
+        }
+    };
+} // namespace ox
+
+#endif // OXLIB_IO_MAPPED_FILE_H
@@ -0,0 +1,97 @@
+#ifndef OXLIB_EXPRESSION_DAG_H
+#define OXLIB_EXPRESSION_DAG_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <iostream>
+#include "_system_solver.h"
+
+namespace ox {
+    namespace system {
+        using symbol_id = std::int32_t;
+        using expr_id = std::int32_t;
+        constexpr inline expr_id no_expr = -1;
+
+        class symbol_table {
+            std::unordered_map<std::string, symbol_id> ids;
+            std::vector<const std::string*> names;
+        public:
+            symbol_id intern(std::string_view name);
+            // -1 if the name was never interned
+            [[nodiscard]] symbol_id find(std::string_view name) const;
+            [[nodiscard]] const std::string& name(symbol_id id) const { return *names[id]; }
+            [[nodiscard]] std::size_t size() const { return names.size(); }
+        };
+
+        struct expr_node {
+            enum class kind : int8_t { constant, symbol, operation };
+
+            kind type;
+            op oper = op::EQUAL;
+            expr_id left = no_expr;
+            expr_id right = no_expr;
+            // constant value, or symbol_id for symbols
+            long value = 0;
+
+            bool operator==(const expr_node&) const = default;
+        };
+
+        struct expr_node_hash {
+            std::size_t operator()(const expr_node& n) const;
+        };
+
+        /*
+         * Hash-consed expression DAG.
+         * Every structurally distinct subexpression exists exactly once and is named by an expr_id, so a rewrite
+         * that reuses a subexpression (like distributing a multiplier over a sum) shares it instead of copying it.
+         * Nodes are immutable; rewrites return new ids and their results are memoized per id.
+         */
+        class expression_dag {
+            std::vector<expr_node> nodes;
+            std::unordered_map<expr_node, expr_id, expr_node_hash> interned;
+            symbol_table symbols;
+
+            std::vector<expr_id> reduced;
+            std::vector<expr_id> expanded;
+            std::unordered_map<std::uint64_t, bool> contains_memo;
+
+            expr_id intern(const expr_node& n);
+            void terms_imp(expr_id id, op sign, std::vector<std::pair<expr_id, op>>& out) const;
+        public:
+            expr_id constant(long value);
+            expr_id symbol(std::string_view name);
+            expr_id make(op oper, expr_id left, expr_id right);
+
+            expr_id from_tree(const math_tree_node& tree);
+            [[nodiscard]] math_tree_node to_tree(expr_id id) const;
+
+            [[nodiscard]] const expr_node& operator[](expr_id id) const { return nodes[id]; }
+            [[nodiscard]] std::size_t size() const { return nodes.size(); }
+            [[nodiscard]] const symbol_table& get_symbols() const { return symbols; }
+            [[nodiscard]] symbol_id find_symbol(std::string_view name) const { return symbols.find(name); }
+
+            [[nodiscard]] bool is_constant(expr_id id) const { return nodes[id].type == expr_node::kind::constant; }
+            [[nodiscard]] bool is_symbol(expr_id id) const { return nodes[id].type == expr_node::kind::symbol; }
+            [[nodiscard]] bool is_operation(expr_id id, op oper) const {
+                return nodes[id].type == expr_node::kind::operation && nodes[id].oper == oper;
+            }
+
+            // The rewrites of ox::system::reduce (constant folding, 0 / 1 / negative constant identities)
+            // plus x - 0 and x / 1
+            expr_id reduce(expr_id id);
+            // Fully distributes multiplication over + and -
+            expr_id expand_multiplication(expr_id id);
+            bool contains(expr_id id, symbol_id symbol);
+
+            // The additive terms of an expression with the sign each is added with
+            [[nodiscard]] std::vector<std::pair<expr_id, op>> terms(expr_id id) const;
+
+            void print(expr_id id, std::ostream& os = std::cout) const;
+        };
+    } // namespace system
+} // namespace ox
+
+#endif // OXLIB_EXPRESSION_DAG_H
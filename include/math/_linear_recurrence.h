@@ -0,0 +1,122 @@
+#ifndef OXLIB_LINEAR_RECURRENCE_H
+#define OXLIB_LINEAR_RECURRENCE_H
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+#include "_rational.h"
+
+namespace ox {
+    /*
+     * Shortest linear recurrence s[i] = c[0] * s[i - 1] + ... + c[k - 1] * s[i - k] generating s, returned as c.
+     * Field needs exact +, -, * and ox::reciprocal (ox::modulo for a prime modulus, ox::rational); 2k terms
+     * determine a recurrence of order k.
+     */
+    template <typename Field>
+    std::vector<Field> berlekamp_massey(std::span<const Field> s) {
+        std::vector<Field> current{Field(1)};
+        std::vector<Field> previous{Field(1)};
+        Field previous_discrepancy = Field(1);
+        std::size_t length = 0;
+        std::size_t shift = 1;
+
+        for (std::size_t n = 0; n < s.size(); ++n) {
+            Field discrepancy = s[n];
+            for (std::size_t i = 1; i <= length; ++i)
+                discrepancy = discrepancy + current[i] * s[n - i];
+            if (discrepancy == Field(0)) {
+                ++shift;
+                continue;
+            }
+            Field factor = discrepancy * reciprocal(previous_discrepancy);
+            bool grows = 2 * length <= n;
+            std::vector<Field> saved;
+            if (grows)
+                saved = current;
+            if (current.size() < previous.size() + shift)
+                current.resize(previous.size() + shift, Field(0));
+            for (std::size_t i = 0; i < previous.size(); ++i)
+                current[i + shift] = current[i + shift] - factor * previous[i];
+            if (grows) {
+                length = n + 1 - length;
+                previous = std::move(saved);
+                previous_discrepancy = discrepancy;
+                shift = 1;
+            } else {
+                ++shift;
+            }
+        }
+
+        std::vector<Field> to_return(length);
+        for (std::size_t i = 0; i < length; ++i)
+            to_return[i] = i + 1 < current.size() ? Field(0) - current[i + 1] : Field(0);
+        return to_return;
+    }
+
+    /*
+     * n-th term (0-based) of the recurrence with coefficients c (as returned by berlekamp_massey) and the first
+     * c.size() terms in initial, in O(k^2 log n): x^n is reduced modulo the characteristic polynomial by
+     * square and multiply, reusing the same two buffers throughout.
+     * Throws std::invalid_argument when initial has fewer than c.size() terms.
+     */
+    template <typename Field>
+    Field kitamasa(std::span<const Field> c, std::span<const Field> initial, std::uint64_t n) {
+        std::size_t k = c.size();
+        if (initial.size() < k)
+            throw std::invalid_argument("kitamasa needs as many initial terms as coefficients");
+        if (n < initial.size())
+            return initial[n];
+        if (k == 0)
+            return Field(0);
+
+        std::vector<Field> result(k, Field(0));
+        std::vector<Field> product(2 * k, Field(0));
+        // x^k = c[0] x^(k-1) + ... + c[k-1], so the top coefficient folds into the k below it
+        auto reduce = [&](std::size_t top) {
+            for (std::size_t i = top; i >= k; --i) {
+                Field coefficient = product[i];
+                if (coefficient == Field(0))
+                    continue;
+                for (std::size_t j = 0; j < k; ++j)
+                    product[i - 1 - j] = product[i - 1 - j] + coefficient * c[j];
+            }
+            std::copy_n(product.begin(), k, result.begin());
+        };
+
+        if (k == 1)
+            result[0] = c[0];
+        else
+            result[1] = Field(1);
+        for (int bit = std::bit_width(n) - 2; bit >= 0; --bit) {
+            std::fill(product.begin(), product.end(), Field(0));
+            for (std::size_t i = 0; i < k; ++i)
+                for (std::size_t j = 0; j < k; ++j)
+                    product[i + j] = product[i + j] + result[i] * result[j];
+            reduce(2 * k - 2);
+            if ((n >> bit) & 1) {
+                std::fill(product.begin(), product.end(), Field(0));
+                std::copy_n(result.begin(), k, product.begin() + 1);
+                reduce(k);
+            }
+        }
+
+        Field to_return = Field(0);
+        for (std::size_t i = 0; i < k; ++i)
+            to_return = to_return + result[i] * initial[i];
+        return to_return;
+    }
+
+    // n-th term of the sequence starting with prefix, continued by the shortest recurrence that generates it
+    template <typename Field>
+    Field linear_recurrence_term(std::span<const Field> prefix, std::uint64_t n) {
+        if (n < prefix.size())
+            return prefix[n];
+        std::vector<Field> c = berlekamp_massey(prefix);
+        return kitamasa<Field>(c, prefix.first(c.size()), n);
+    }
+} // namespace ox
+
+#endif // OXLIB_LINEAR_RECURRENCE_H
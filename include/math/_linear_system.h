@@ -0,0 +1,254 @@
+#ifndef OXLIB_LINEAR_SYSTEM_H
+#define OXLIB_LINEAR_SYSTEM_H
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <map>
+#include <optional>
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include "_rational.h"
+#include "_expression_dag.h"
+
+namespace ox {
+    namespace system {
+        struct nonlinear_equation_error : std::invalid_argument {
+            using std::invalid_argument::invalid_argument;
+        };
+
+        enum class solution_kind { unique, underdetermined, inconsistent };
+
+        template <typename Field>
+        struct linear_solution {
+            solution_kind kind;
+            // Indexed by column: the variable name, its value and whether it was left free
+            std::vector<std::string> variables;
+            // For underdetermined systems, the particular solution with every free variable set to zero
+            std::vector<Field> values;
+            std::vector<bool> free;
+
+            [[nodiscard]] std::optional<Field> value_of(std::string_view name) const {
+                auto it = std::ranges::find(variables, name);
+                if (kind == solution_kind::inconsistent || it == variables.end())
+                    return std::nullopt;
+                return values[it - variables.begin()];
+            }
+        };
+
+        /*
+         * A set of linear equations lowered into a sparse coefficient matrix over Field.
+         * Field needs construction from long, exact +, -, * and ox::reciprocal (ox::rational, or ox::modulo for a
+         * prime modulus), and solve() runs Gauss-Jordan elimination over it, choosing the sparsest row as pivot to
+         * limit fill-in.
+         */
+        template <typename Field = rational>
+        class linear_system {
+            using sparse_row = std::vector<std::pair<int, Field>>;
+
+            struct linear_form {
+                std::map<int, Field> coefficients;
+                Field constant{0};
+            };
+
+            expression_dag dag;
+            std::vector<int> column_of_symbol;
+            std::vector<std::string> variables;
+            std::vector<sparse_row> rows;
+            std::vector<Field> rhs;
+            std::unordered_map<expr_id, linear_form> forms;
+
+            static bool is_zero(const Field& f) { return f == Field(0); }
+
+            // Fields with deferred reduction (ox::rational) are reduced once per stored entry
+            static Field& normalized(Field& f) {
+                if constexpr (requires { f.normalize(); })
+                    f.normalize();
+                return f;
+            }
+
+            int column(symbol_id symbol) {
+                if (column_of_symbol.size() <= std::size_t(symbol))
+                    column_of_symbol.resize(symbol + 1, -1);
+                if (column_of_symbol[symbol] < 0) {
+                    column_of_symbol[symbol] = int(variables.size());
+                    variables.push_back(dag.get_symbols().name(symbol));
+                }
+                return column_of_symbol[symbol];
+            }
+
+            static linear_form scaled(linear_form f, const Field& by) {
+                for (auto& [col, c] : f.coefficients)
+                    c = c * by;
+                f.constant = f.constant * by;
+                return f;
+            }
+
+            static linear_form combined(linear_form l, const linear_form& r, bool subtract) {
+                for (const auto& [col, c] : r.coefficients) {
+                    auto& dest = l.coefficients[col];
+                    dest = subtract ? dest - c : dest + c;
+                }
+                l.constant = subtract ? l.constant - r.constant : l.constant + r.constant;
+                return l;
+            }
+
+            const linear_form& lower(expr_id id) {
+                if (auto it = forms.find(id); it != forms.end())
+                    return it->second;
+
+                const expr_node n = dag[id];
+                linear_form result;
+                if (n.type == expr_node::kind::constant) {
+                    result.constant = Field(n.value);
+                } else if (n.type == expr_node::kind::symbol) {
+                    result.coefficients.emplace(column(symbol_id(n.value)), Field(1));
+                } else {
+                    linear_form left = lower(n.left);
+                    linear_form right = lower(n.right);
+                    switch (n.oper) {
+                        case op::PLUS:
+                            result = combined(std::move(left), right, false);
+                            break;
+                        case op::MIN:
+                        case op::EQUAL:
+                            result = combined(std::move(left), right, true);
+                            break;
+                        case op::MUL:
+                            if (right.coefficients.empty())
+                                result = scaled(std::move(left), right.constant);
+                            else if (left.coefficients.empty())
+                                result = scaled(std::move(right), left.constant);
+                            else
+                                throw nonlinear_equation_error("Product of two variable terms");
+                            break;
+                        case op::DIV:
+                            if (!right.coefficients.empty())
+                                throw nonlinear_equation_error("Division by a variable term");
+                            if (is_zero(right.constant))
+                                throw div_by_zero_error("Divide By Zero");
+                            result = scaled(std::move(left), reciprocal(right.constant));
+                            break;
+                    }
+                }
+                return forms.emplace(id, std::move(result)).first->second;
+            }
+
+            static const Field* find_coefficient(const sparse_row& row, int col) {
+                auto it = std::ranges::lower_bound(row, col, {}, &std::pair<int, Field>::first);
+                return it != row.end() && it->first == col ? &it->second : nullptr;
+            }
+
+            // dest - factor * src, dropping cancelled entries
+            static sparse_row subtract_scaled(const sparse_row& dest, const Field& factor, const sparse_row& src) {
+                sparse_row to_return;
+                to_return.reserve(dest.size() + src.size());
+                auto d = dest.begin();
+                auto s = src.begin();
+                while (d != dest.end() || s != src.end()) {
+                    if (s == src.end() || (d != dest.end() && d->first < s->first)) {
+                        to_return.push_back(*d++);
+                    } else if (d == dest.end() || s->first < d->first) {
+                        Field value = Field(0) - factor * s->second;
+                        to_return.emplace_back(s->first, normalized(value));
+                        ++s;
+                    } else {
+                        Field value = d->second - factor * s->second;
+                        if (!is_zero(value))
+                            to_return.emplace_back(d->first, normalized(value));
+                        ++d;
+                        ++s;
+                    }
+                }
+                return to_return;
+            }
+        public:
+            // Adds lhs = rhs
+            void add_equation(const math_tree_node& lhs, const math_tree_node& rhs) {
+                add_equation(dag.make(op::MIN, dag.from_tree(lhs), dag.from_tree(rhs)));
+            }
+
+            // Adds an equation whose root is op::EQUAL, or an expression taken to equal zero
+            void add_equation(const math_tree_node& equation) { add_equation(dag.from_tree(equation)); }
+
+            // Adds an expression of the internal DAG taken to equal zero
+            void add_equation(expr_id expression) {
+                const linear_form& form = lower(expression);
+                sparse_row row;
+                for (const auto& [col, c] : form.coefficients)
+                    if (!is_zero(c))
+                        row.emplace_back(col, c);
+                rows.push_back(std::move(row));
+                rhs.push_back(Field(0) - form.constant);
+            }
+
+            [[nodiscard]] std::size_t equation_count() const { return rows.size(); }
+            [[nodiscard]] std::size_t variable_count() const { return variables.size(); }
+            [[nodiscard]] const std::vector<std::string>& get_variables() const { return variables; }
+
+            [[nodiscard]] linear_solution<Field> solve() const {
+                std::vector<sparse_row> m = rows;
+                std::vector<Field> b = rhs;
+                int columns = int(variables.size());
+                std::vector<int> pivot_row_of(columns, -1);
+                std::vector<bool> used(m.size());
+
+                for (int col = 0; col < columns; ++col) {
+                    int pivot = -1;
+                    for (int r = 0; r < int(m.size()); ++r) {
+                        if (!used[r] && find_coefficient(m[r], col) && (pivot < 0 || m[r].size() < m[pivot].size()))
+                            pivot = r;
+                    }
+                    if (pivot < 0)
+                        continue;
+                    used[pivot] = true;
+                    pivot_row_of[col] = pivot;
+
+                    Field inverse = reciprocal(*find_coefficient(m[pivot], col));
+                    for (auto& [c, value] : m[pivot]) {
+                        value = value * inverse;
+                        normalized(value);
+                    }
+                    b[pivot] = b[pivot] * inverse;
+                    normalized(b[pivot]);
+
+                    for (int r = 0; r < int(m.size()); ++r) {
+                        if (r == pivot)
+                            continue;
+                        const Field* factor = find_coefficient(m[r], col);
+                        if (!factor)
+                            continue;
+                        Field f = *factor;
+                        m[r] = subtract_scaled(m[r], f, m[pivot]);
+                        b[r] = b[r] - f * b[pivot];
+                        normalized(b[r]);
+                    }
+                }
+
+                linear_solution<Field> to_return{solution_kind::unique, variables, std::vector<Field>(columns, Field(0)),
+                                                 std::vector<bool>(columns)};
+                for (std::size_t r = 0; r < m.size(); ++r) {
+                    if (m[r].empty() && !is_zero(b[r])) {
+                        to_return.kind = solution_kind::inconsistent;
+                        return to_return;
+                    }
+                }
+                for (int col = 0; col < columns; ++col) {
+                    if (pivot_row_of[col] < 0) {
+                        to_return.kind = solution_kind::underdetermined;
+                        to_return.free[col] = true;
+                    }
+                }
+                // reduced row echelon form: with free variables at zero each pivot variable is its row's rhs
+                for (int col = 0; col < columns; ++col)
+                    if (pivot_row_of[col] >= 0)
+                        to_return.values[col] = b[pivot_row_of[col]];
+                return to_return;
+            }
+        };
+    } // namespace system
+} // namespace ox
+
+#endif // OXLIB_LINEAR_SYSTEM_H
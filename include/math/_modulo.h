@@ -1,69 +1,280 @@
 #pragma once
 #include <concepts>
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "_rational.h"
 
-#define OP_ASSIGNMENT(op, T, val) \
-  T& operator op##=(const T& other) { \
-    val op## = other.val; \
-    update(); \
-    return *this; \
-  } \
-  T& operator op##=(const std::integral auto& other) { \
-    val op## = other; \
-    update(); \
-    return *this; \
-  }
 #define OPERATOR_EXPANSION(op, T) \
-  T operator op(const T& other) const { \
+  constexpr T operator op(const T& other) const { \
     T ret{*this}; \
     ret op## = other; \
     return ret; \
   } \
-  T operator op(const std::integral auto& other) const { \
+  constexpr T operator op(const std::integral auto& other) const { \
     T ret{*this}; \
     ret op## = other; \
     return ret; \
   }
 
 namespace ox {
+    namespace details {
+#ifdef __SIZEOF_INT128__
+        using u128 = unsigned __int128;
+
+        // Residues kept as x * 2^64 mod M, for odd M below 2^63
+        template <std::uint64_t M>
+        struct montgomery_reduction {
+            // M * inverse == 1 mod 2^64, by Newton iteration (each step doubles the correct low bits)
+            static constexpr std::uint64_t inverse = [] {
+                std::uint64_t x = M;
+                for (int i = 0; i < 5; ++i)
+                    x *= 2 - M * x;
+                return x;
+            }();
+            static constexpr std::uint64_t r2 = std::uint64_t((u128(1) << 64) % M * ((u128(1) << 64) % M) % M);
+
+            // t * 2^-64 mod M for t < M * 2^64
+            static constexpr std::uint64_t reduce(u128 t) {
+                std::uint64_t m = std::uint64_t(t) * inverse;
+                std::uint64_t mn = std::uint64_t((u128(m) * M) >> 64);
+                std::uint64_t high = std::uint64_t(t >> 64);
+                return high >= mn ? high - mn : high - mn + M;
+            }
+
+            static constexpr std::uint64_t to(std::uint64_t x) { return reduce(u128(x) * r2); }
+            static constexpr std::uint64_t from(std::uint64_t x) { return reduce(x); }
+            static constexpr std::uint64_t multiply(std::uint64_t a, std::uint64_t b) { return reduce(u128(a) * b); }
+        };
+
+        // Plain residues reduced with a precomputed reciprocal, for M up to 2^32 so products fit in 64 bits
+        template <std::uint64_t M>
+        struct barrett_reduction {
+            static constexpr std::uint64_t factor = std::uint64_t(-1) / M;
+
+            static constexpr std::uint64_t reduce(std::uint64_t x) {
+                std::uint64_t q = std::uint64_t((u128(x) * factor) >> 64);
+                std::uint64_t r = x - q * M;
+                return r >= M ? r - M : r;
+            }
+
+            static constexpr std::uint64_t to(std::uint64_t x) { return x; }
+            static constexpr std::uint64_t from(std::uint64_t x) { return x; }
+            static constexpr std::uint64_t multiply(std::uint64_t a, std::uint64_t b) { return reduce(a * b); }
+        };
+
+        template <std::uint64_t M>
+        struct plain_reduction {
+            static constexpr std::uint64_t to(std::uint64_t x) { return x; }
+            static constexpr std::uint64_t from(std::uint64_t x) { return x; }
+            static constexpr std::uint64_t multiply(std::uint64_t a, std::uint64_t b) {
+                return std::uint64_t(u128(a) * b % M);
+            }
+        };
+
+        template <std::uint64_t M>
+        using reduction_for = std::conditional_t<
+                (M % 2 == 1 && M > 1 && M < (std::uint64_t(1) << 63)), montgomery_reduction<M>,
+                std::conditional_t<(M > 1 && M <= (std::uint64_t(1) << 32)), barrett_reduction<M>, plain_reduction<M>>>;
+#else
+        // Without 128-bit integers: a single multiply while products fit in 64 bits, doubling and adding beyond
+        template <std::uint64_t M>
+        struct plain_reduction {
+            static constexpr std::uint64_t to(std::uint64_t x) { return x; }
+            static constexpr std::uint64_t from(std::uint64_t x) { return x; }
+            static constexpr std::uint64_t multiply(std::uint64_t a, std::uint64_t b) {
+                if constexpr (M <= (std::uint64_t(1) << 32))
+                    return a * b % M;
+                std::uint64_t to_return = 0;
+                for (; b; b >>= 1) {
+                    if (b & 1)
+                        to_return = to_return >= M - a ? to_return - (M - a) : to_return + a;
+                    a = a >= M - a ? a - (M - a) : a + a;
+                }
+                return to_return;
+            }
+        };
+
+        template <std::uint64_t M>
+        using reduction_for = plain_reduction<M>;
+#endif
+
+        // in mod M, in [0, M)
+        template <std::uint64_t M, std::integral I>
+        constexpr std::uint64_t canonical(I in) {
+            using wide = std::conditional_t<(sizeof(I) > sizeof(std::uint64_t)), std::make_unsigned_t<I>, std::uint64_t>;
+            if constexpr (std::is_signed_v<I>) {
+                if (in < 0)
+                    return M - 1 - std::uint64_t(wide(-(in + 1)) % M);
+            }
+            return std::uint64_t(wide(in) % M);
+        }
+    } // namespace details
+
+    /*
+     * Residue modulo the compile time constant M.
+     * Products use 128-bit intermediates, so they never overflow before being reduced. Odd moduli keep the residue
+     * in Montgomery form, making a multiplication a few integer multiplies instead of a division, and other moduli
+     * up to 2^32 use Barrett reduction. Compilers without 128-bit integers reduce every product with a plain %.
+     * value() (or the conversion to T) gives the residue in [0, M).
+     * There is no modular operator /: as before, m / k converts m to T and divides the integers. Use divide() or
+     * inverse() for the modular quotient, which throws div_by_zero_error when the divisor shares a factor with M.
+     */
     template <size_t M, std::integral T = long>
     struct modulo {
-        T result;
+    private:
+        using reduction = details::reduction_for<M>;
+        // In the representation of reduction, always in [0, M)
+        std::uint64_t residue = 0;
+    public:
+        constexpr modulo() = default;
+        constexpr modulo(std::integral auto in) : residue(reduction::to(details::canonical<M>(in))) {}
+
+        [[nodiscard]] constexpr T value() const { return T(reduction::from(residue)); }
+
+        constexpr operator T() const { return value(); }
+
+        constexpr modulo& operator+=(const modulo& other) {
+            residue = residue >= M - other.residue ? residue - (M - other.residue) : residue + other.residue;
+            return *this;
+        }
+        constexpr modulo& operator-=(const modulo& other) {
+            residue = residue >= other.residue ? residue - other.residue : residue + (M - other.residue);
+            return *this;
+        }
+        constexpr modulo& operator*=(const modulo& other) {
+            residue = reduction::multiply(residue, other.residue);
+            return *this;
+        }
 
-        modulo() = default;
-        modulo(std::integral auto in) : result(in){ update(); };
+        constexpr modulo& operator+=(const std::integral auto& other) { return *this += modulo(other); }
+        constexpr modulo& operator-=(const std::integral auto& other) { return *this -= modulo(other); }
+        constexpr modulo& operator*=(const std::integral auto& other) { return *this *= modulo(other); }
 
-        OP_ASSIGNMENT(+, modulo, result);
         OPERATOR_EXPANSION(+, modulo)
-        OP_ASSIGNMENT(-, modulo, result);
         OPERATOR_EXPANSION(-, modulo)
-        OP_ASSIGNMENT(*, modulo, result);
         OPERATOR_EXPANSION(*, modulo)
 
-        modulo& operator++() { return *this += 1; }
-        modulo& operator--() { return *this -= 1; }
+        constexpr modulo operator-() const { return modulo() - *this; }
 
-        modulo operator++(int) {
+        constexpr modulo& operator++() { return *this += 1; }
+        constexpr modulo& operator--() { return *this -= 1; }
+
+        constexpr modulo operator++(int) {
             modulo ret{*this};
             *this += 1;
             return ret;
         }
-        modulo operator--(int) {
+        constexpr modulo operator--(int) {
             modulo ret{*this};
             *this -= 1;
             return ret;
         }
 
-        operator T() { return result; }
-    private:
-        void update() {
-            result %= M;
-            if (result < 0) {
-                result += M;
+        constexpr bool operator==(const modulo& other) const { return residue == other.residue; }
+        constexpr bool operator==(const std::integral auto& other) const { return *this == modulo(other); }
+
+        [[nodiscard]] constexpr modulo pow(std::uint64_t exponent) const {
+            modulo to_return = 1;
+            modulo base = *this;
+            for (; exponent; exponent >>= 1) {
+                if (exponent & 1)
+                    to_return *= base;
+                base *= base;
             }
+            return to_return;
         }
+
+        // Extended Euclid, so M need not be prime; throws if the value shares a factor with M
+        [[nodiscard]] constexpr modulo inverse() const {
+            std::uint64_t a = reduction::from(residue);
+            std::uint64_t m = M;
+#ifdef __SIZEOF_INT128__
+            __int128 x0 = 1, x1 = 0;
+            while (m) {
+                std::uint64_t q = a / m;
+                a = std::exchange(m, a - q * m);
+                x0 = std::exchange(x1, x0 - __int128(q) * x1);
+            }
+            if (a != 1)
+                throw div_by_zero_error("Residue is not invertible");
+            x0 %= __int128(M);
+            return modulo(std::uint64_t(x0 < 0 ? x0 + __int128(M) : x0));
+#else
+            // the Bezout coefficients are kept as residues, since they may not fit a signed 64 bit integer
+            modulo x0 = 1, x1 = 0;
+            while (m) {
+                std::uint64_t q = a / m;
+                a = std::exchange(m, a - q * m);
+                x0 = std::exchange(x1, x0 - modulo(q) * x1);
+            }
+            if (a != 1)
+                throw div_by_zero_error("Residue is not invertible");
+            return x0;
+#endif
+        }
+
+        // *this times the inverse of other
+        [[nodiscard]] constexpr modulo divide(const modulo& other) const { return *this * other.inverse(); }
     };
 
+    template <typename>
+    struct is_modulo : std::false_type {};
+    template <size_t M, std::integral T>
+    struct is_modulo<modulo<M, T>> : std::true_type {};
+
+    template <typename R>
+    concept modulo_range = std::ranges::random_access_range<R> && is_modulo<std::ranges::range_value_t<R>>::value;
+
+    template <size_t M, std::integral T = long, std::ranges::input_range R>
+    std::vector<modulo<M, T>> to_residues(R&& values) {
+        std::vector<modulo<M, T>> to_return;
+        if constexpr (std::ranges::sized_range<R>)
+            to_return.reserve(std::ranges::size(values));
+        for (auto&& v : values)
+            to_return.emplace_back(v);
+        return to_return;
+    }
+
+    // Inverts every element with a single modular inverse (Montgomery's trick)
+    template <modulo_range R>
+    void batch_inverse(R&& values) {
+        using mod_t = std::ranges::range_value_t<R>;
+        auto n = std::ranges::size(values);
+        if (n == 0)
+            return;
+        std::vector<mod_t> prefix(n);
+        mod_t product = 1;
+        for (std::size_t i = 0; i < n; ++i) {
+            prefix[i] = product;
+            product *= values[i];
+        }
+        product = product.inverse();
+        for (std::size_t i = n; i-- > 0;) {
+            mod_t v = values[i];
+            values[i] = product * prefix[i];
+            product *= v;
+        }
+    }
+
+    // values[i] *= by[i]
+    template <modulo_range R, modulo_range S>
+    void batch_multiply(R&& values, const S& by) {
+        auto n = std::min(std::ranges::size(values), std::ranges::size(by));
+        for (std::size_t i = 0; i < n; ++i)
+            values[i] *= by[i];
+    }
+
+    template <modulo_range R>
+    void batch_pow(R&& values, std::uint64_t exponent) {
+        for (auto& v : values)
+            v = v.pow(exponent);
+    }
+
     template <std::integral T>
     T mod(T divisor, T denominator) {
         return divisor - denominator * (T)floor((double)divisor/denominator);
@@ -75,5 +286,4 @@ namespace ox {
     }
 } // namespace ox
 
-#undef OP_ASSIGNMENT
 #undef OPERATOR_EXPANSION
@@ -6,74 +6,313 @@
 #define OXLIB_RATIONAL_H
 
 #include <cmath>
+#include <bit>
+#include <compare>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
 
 namespace ox {
     struct div_by_zero_error : std::overflow_error {
         using std::overflow_error::overflow_error;
     };
 
-    struct rational {
-        long numerator;
-        long denominator;
+    struct rational_overflow_error : std::overflow_error {
+        using std::overflow_error::overflow_error;
+    };
+
+    namespace details {
+        template <typename Int>
+        struct unsigned_of {
+            using type = std::make_unsigned_t<Int>;
+        };
+#ifdef __SIZEOF_INT128__
+        template <>
+        struct unsigned_of<__int128> {
+            using type = unsigned __int128;
+        };
+#endif
+        template <typename Int>
+        using unsigned_of_t = typename unsigned_of<Int>::type;
+
+        // Type able to hold the product of two Int, void if there is none
+        template <typename Int>
+        struct wider_of {
+            using type = void;
+        };
+        template <typename Int>
+        requires(sizeof(Int) <= 4)
+        struct wider_of<Int> {
+            using type = long long;
+        };
+#ifdef __SIZEOF_INT128__
+        template <typename Int>
+        requires(sizeof(Int) == 8)
+        struct wider_of<Int> {
+            using type = __int128;
+        };
+#endif
+        template <typename Int>
+        using wider_of_t = typename wider_of<Int>::type;
+
+        template <typename UInt>
+        constexpr int countr_zero(UInt x) {
+            if constexpr (sizeof(UInt) <= sizeof(std::uint64_t)) {
+                return std::countr_zero(std::uint64_t(x));
+            } else {
+                auto low = std::uint64_t(x);
+                return low ? std::countr_zero(low) : 64 + std::countr_zero(std::uint64_t(x >> 64));
+            }
+        }
+    } // namespace details
+
+    /*
+     * Stein's binary gcd, always non-negative.
+     * The only gcd a signed Int cannot hold is -min, of min with itself or with 0, which throws rational_overflow_error.
+     */
+    template <typename Int>
+    constexpr Int binary_gcd(Int a, Int b) {
+        using U = details::unsigned_of_t<Int>;
+        U u = a < 0 ? U(0) - U(a) : U(a);
+        U v = b < 0 ? U(0) - U(b) : U(b);
+        auto fitted = [](U gcd) {
+            // conversion to Int wraps, and only -min wraps to a negative value
+            Int to_return = Int(gcd);
+            if (to_return < Int(0))
+                throw rational_overflow_error("Rational overflow");
+            return to_return;
+        };
+        if (u == 0)
+            return fitted(v);
+        if (v == 0)
+            return fitted(u);
+        int shift = details::countr_zero(U(u | v));
+        u >>= details::countr_zero(u);
+        do {
+            v >>= details::countr_zero(v);
+            if (u > v)
+                std::swap(u, v);
+            v -= u;
+        } while (v != 0);
+        return fitted(U(u << shift));
+    }
+
+    struct unnormalized_t {
+        explicit unnormalized_t() = default;
+    };
+    inline constexpr unnormalized_t unnormalized{};
 
-        constexpr rational() : numerator{0}, denominator{1} {}
-        constexpr rational(long n) : numerator{n}, denominator{1} {}
-        constexpr rational(long n, long m) : numerator{n}, denominator{m} {
+    /*
+     * Exact fraction over Int.
+     * Arithmetic results are not reduced: operators first try the plain cross-multiplication and only fall back to
+     * gcd-reduced operands when that would overflow, throwing rational_overflow_error if the reduced form overflows
+     * too. Comparisons are exact whatever the representation, so call normalize() only when the canonical
+     * numerator / denominator pair itself is needed.
+     * The denominator is always positive.
+     */
+    template <typename Int>
+    struct basic_rational {
+        Int numerator;
+        Int denominator;
+
+        constexpr basic_rational() : numerator{0}, denominator{1} {}
+        constexpr basic_rational(Int n) : numerator{n}, denominator{1} {}
+        constexpr basic_rational(Int n, Int m) : numerator{n}, denominator{m} {
             if (n == 0)
                 denominator = 1;
             else if (m == 0)
                 throw div_by_zero_error("Divide By Zero");
             else
-                reduce();
+                normalize();
         }
-    private:
-        constexpr void reduce() {
-            auto r = std::gcd(numerator, denominator);
+        // Takes n / m as is; m must be positive
+        constexpr basic_rational(Int n, Int m, unnormalized_t) : numerator{n}, denominator{m} {}
+
+        constexpr basic_rational& normalize() {
+            auto r = binary_gcd(numerator, denominator);
+            if (r == 0)
+                return *this;
+            if (denominator < 0)
+                r = -r;
             numerator /= r;
             denominator /= r;
+            return *this;
+        }
+
+        [[nodiscard]] constexpr basic_rational normalized() const {
+            basic_rational cpy = *this;
+            return cpy.normalize();
+        }
+
+        [[nodiscard]] constexpr bool is_normalized() const {
+            return denominator > 0 && binary_gcd(numerator, denominator) == 1;
+        }
+    private:
+        static constexpr Int checked_mul(Int a, Int b) {
+            Int result;
+            if (__builtin_mul_overflow(a, b, &result))
+                throw rational_overflow_error("Rational overflow");
+            return result;
+        }
+
+        static constexpr Int checked_add(Int a, Int b) {
+            Int result;
+            if (__builtin_add_overflow(a, b, &result))
+                throw rational_overflow_error("Rational overflow");
+            return result;
+        }
+
+        template <typename Wide>
+        static constexpr Int narrowed(Wide value) {
+            if (value < Wide(std::numeric_limits<Int>::min()) || value > Wide(std::numeric_limits<Int>::max()))
+                throw rational_overflow_error("Rational overflow");
+            return Int(value);
+        }
+
+        // Knuth 4.5.1: with reduced operands every gcd is taken over the smaller factors
+        static constexpr basic_rational reduced_sum(const basic_rational& x, const basic_rational& y) {
+            Int d1 = binary_gcd(x.denominator, y.denominator);
+            using Wide = details::wider_of_t<Int>;
+            if constexpr (!std::is_void_v<Wide>) {
+                // the cross terms may not fit in Int while the reduced sum does, so only the result is narrowed
+                Wide t = Wide(x.numerator) * Wide(y.denominator / d1) + Wide(y.numerator) * Wide(x.denominator / d1);
+                Int d2 = d1 == 1 ? Int(1) : Int(binary_gcd(t, Wide(d1)));
+                return {narrowed(t / d2),
+                        narrowed(Wide(x.denominator / d1) * Wide(y.denominator / d2)),
+                        unnormalized};
+            } else {
+                if (d1 == 1) {
+                    return {checked_add(checked_mul(x.numerator, y.denominator),
+                                        checked_mul(y.numerator, x.denominator)),
+                            checked_mul(x.denominator, y.denominator),
+                            unnormalized};
+                }
+                Int t = checked_add(checked_mul(x.numerator, y.denominator / d1),
+                                    checked_mul(y.numerator, x.denominator / d1));
+                Int d2 = binary_gcd(t, d1);
+                if (d2 == 0)
+                    return {};
+                return {t / d2, checked_mul(x.denominator / d1, y.denominator / d2), unnormalized};
+            }
+        }
+
+        static constexpr basic_rational reduced_product(const basic_rational& x, const basic_rational& y) {
+            Int g1 = binary_gcd(x.numerator, y.denominator);
+            Int g2 = binary_gcd(y.numerator, x.denominator);
+            if (g1 == 0 || g2 == 0)
+                return {};
+            return {checked_mul(x.numerator / g1, y.numerator / g2),
+                    checked_mul(x.denominator / g2, y.denominator / g1),
+                    unnormalized};
+        }
+
+        // Exact three way comparison of a / b and c / d for positive b and d, without a wider type
+        static constexpr std::strong_ordering compare_fractions(Int a, Int b, Int c, Int d) {
+            while (true) {
+                Int q1 = a / b - (a % b < 0);
+                Int q2 = c / d - (c % d < 0);
+                if (q1 != q2)
+                    return q1 <=> q2;
+                Int r1 = a - q1 * b;
+                Int r2 = c - q2 * d;
+                if (r1 == 0 || r2 == 0)
+                    return r1 <=> r2;
+                // r1 / b <=> r2 / d is the reverse of b / r1 <=> d / r2
+                a = d;
+                c = b;
+                b = r2;
+                d = r1;
+            }
         }
     public:
-        constexpr rational operator+(const rational& other) const {
-            auto new_denominator = std::lcm(denominator, other.denominator);
-            auto new_numerator = numerator * std::gcd(denominator, new_denominator)
-                               + other.numerator * std::gcd(other.denominator, new_denominator);
-            return {new_numerator, new_denominator};
+        constexpr basic_rational operator+(const basic_rational& other) const {
+            Int ad, cb, bd, n;
+            if (!__builtin_mul_overflow(numerator, other.denominator, &ad)
+                && !__builtin_mul_overflow(other.numerator, denominator, &cb)
+                && !__builtin_mul_overflow(denominator, other.denominator, &bd)
+                && !__builtin_add_overflow(ad, cb, &n)) {
+                return {n, bd, unnormalized};
+            }
+            return reduced_sum(normalized(), other.normalized());
         }
 
-        constexpr rational operator-() const { return {-numerator, denominator}; }
+        constexpr basic_rational operator-() const { return {checked_mul(numerator, Int(-1)), denominator, unnormalized}; }
 
-        constexpr rational operator-(const rational& other) const { return *this + (-other); }
+        constexpr basic_rational operator-(const basic_rational& other) const { return *this + (-other); }
 
-        constexpr rational operator*(const rational& other) const {
-            auto new_numerator = numerator * other.numerator;
-            auto new_denominator = denominator * other.denominator;
-            return {new_numerator, new_denominator};
+        constexpr basic_rational operator*(const basic_rational& other) const {
+            Int n, d;
+            if (!__builtin_mul_overflow(numerator, other.numerator, &n)
+                && !__builtin_mul_overflow(denominator, other.denominator, &d)) {
+                return {n, d, unnormalized};
+            }
+            return reduced_product(normalized(), other.normalized());
         }
 
-        constexpr rational operator/(const rational& other) const {
-            return *this * rational(other.denominator, other.numerator);
+        [[nodiscard]] constexpr basic_rational reciprocal() const {
+            if (numerator == 0)
+                throw div_by_zero_error("Divide By Zero");
+            if (numerator < 0)
+                return {checked_mul(denominator, Int(-1)), checked_mul(numerator, Int(-1)), unnormalized};
+            return {denominator, numerator, unnormalized};
         }
 
+        constexpr basic_rational operator/(const basic_rational& other) const { return *this * other.reciprocal(); }
+
+        constexpr basic_rational& operator+=(const basic_rational& other) { return *this = *this + other; }
+        constexpr basic_rational& operator-=(const basic_rational& other) { return *this = *this - other; }
+        constexpr basic_rational& operator*=(const basic_rational& other) { return *this = *this * other; }
+        constexpr basic_rational& operator/=(const basic_rational& other) { return *this = *this / other; }
+
         template <std::floating_point F>
-        explicit operator F() const {
+        constexpr explicit operator F() const {
             return F(numerator) / F(denominator);
         }
         template <std::integral F>
-        explicit operator F() const {
-            return numerator / denominator;
+        constexpr explicit operator F() const {
+            return F(numerator / denominator);
         }
 
-        constexpr bool operator==(const rational& other) const = default;
-        constexpr auto operator<=>(const rational& other) const {
-            return double(*this) <=> double(other);
+        constexpr std::strong_ordering operator<=>(const basic_rational& other) const {
+            using Wide = details::wider_of_t<Int>;
+            if constexpr (!std::is_void_v<Wide>) {
+                return Wide(numerator) * Wide(other.denominator) <=> Wide(other.numerator) * Wide(denominator);
+            } else {
+                Int ad, cb;
+                if (!__builtin_mul_overflow(numerator, other.denominator, &ad)
+                    && !__builtin_mul_overflow(other.numerator, denominator, &cb))
+                    return ad <=> cb;
+                return compare_fractions(numerator, denominator, other.numerator, other.denominator);
+            }
         }
 
-        //    constexpr auto operator<=>(const rational& other) const {
-        //        auto common_denominator = std::lcm(denominator, other.denominator);
-        //        return numerator * std::gcd(denominator, common_denominator)
-        //           <=> other.numerator * std::gcd(other.denominator, common_denominator);
-        //    }
+        constexpr bool operator==(const basic_rational& other) const {
+            if (numerator == other.numerator && denominator == other.denominator)
+                return true;
+            return (*this <=> other) == 0;
+        }
     };
-}
+
+    /*
+     * 1 / x for an element of a field: x.inverse() for types whose / is not the field division (ox::modulo divides
+     * its residue as an integer), 1 / x otherwise.
+     */
+    template <typename Field>
+    constexpr Field reciprocal(const Field& x) {
+        if constexpr (requires { { x.inverse() } -> std::same_as<Field>; })
+            return x.inverse();
+        else
+            return Field(1) / x;
+    }
+
+    using rational = basic_rational<long>;
+#ifdef __SIZEOF_INT128__
+    using rational128 = basic_rational<__int128>;
+#endif
+} // namespace ox
 
 #endif // OXLIB_RATIONAL_H
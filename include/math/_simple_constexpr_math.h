@@ -3,6 +3,7 @@
 
 #include <numeric>
 #include <cassert>
+#include <ranges>
 
 namespace ox {
     constexpr inline int power_of_2(unsigned x) {
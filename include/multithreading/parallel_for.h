@@ -0,0 +1,62 @@
+#ifndef OXLIB_PARALLEL_FOR_H
+#define OXLIB_PARALLEL_FOR_H
+
+#include "threadpool.h"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace ox {
+    /*
+     * Runs f(i) for every i in [0, count) on pool and on the calling thread, and returns once all of them are done.
+     * Indices are claimed one at a time from a shared counter, and the caller claims them too instead of only
+     * waiting, so it only ever waits for calls already running elsewhere: calling it from inside a pool task, even
+     * on a single worker pool, cannot deadlock. An exception thrown by f is rethrown here, the lowest index's first.
+     */
+    template <typename F>
+    void parallel_for(thread_pool<std::function<void()>>& pool, std::size_t count, F f) {
+        struct state {
+            std::atomic<std::size_t> next{0};
+            std::atomic<std::size_t> finished{0};
+            std::size_t count;
+            F* f;
+            std::vector<std::exception_ptr> errors;
+
+            state(std::size_t _count, F* _f) : count(_count), f(_f), errors(_count) {}
+
+            // Claims and runs indices until none are left; f is only touched while one is claimed
+            void work() {
+                for (std::size_t i; (i = next.fetch_add(1)) < count;) {
+                    try {
+                        (*f)(i);
+                    } catch (...) {
+                        errors[i] = std::current_exception();
+                    }
+                    if (finished.fetch_add(1) + 1 == count)
+                        finished.notify_all();
+                }
+            }
+        };
+
+        if (count == 0)
+            return;
+        // helpers the pool only starts after the work is over find nothing to claim, the state outlives them
+        auto shared = std::make_shared<state>(count, &f);
+        std::size_t helpers = std::min<std::size_t>(count - 1, std::max(1u, std::thread::hardware_concurrency()));
+        for (std::size_t i = 0; i < helpers; ++i)
+            pool.submit([shared] { shared->work(); });
+        shared->work();
+        for (std::size_t done; (done = shared->finished.load()) != count;)
+            shared->finished.wait(done);
+        for (const auto& error : shared->errors)
+            if (error)
+                std::rethrow_exception(error);
+    }
+} // namespace ox
+
+#endif // OXLIB_PARALLEL_FOR_H
@@ -1,7 +1,9 @@
 #ifndef OXLIB_BYTES_H
 #define OXLIB_BYTES_H
 
+#include <algorithm>
 #include <cstddef>
+#include <cstring>
 #include <string>
 #include <array>
 #include <concepts>
@@ -10,6 +12,10 @@
 #include <type_traits>
 #include <bit>
 
+#if defined(__AVX2__) || defined(__SSSE3__)
+#include <immintrin.h>
+#endif
+
 namespace ox {
     using namespace ox::int_alias;
     enum {
@@ -38,23 +44,61 @@ namespace ox {
     constexpr u32 O32_HOST_ORDER = std::bit_cast<u32>(o32_host_order);
 
     template <std::integral T>
-    T bswap(T number) {
-        constexpr int size = sizeof(T);
-        if constexpr (size == 1) {
+    constexpr T bswap(T number) {
+        static_assert(sizeof(T) <= 8, "no byte swap builtin for integers wider than 64 bits");
+        if constexpr (sizeof(T) == 1)
             return number;
-        } else {
-            using UT = std::make_unsigned_t<T>;
-            UT result{};
-            for(int i = size; i > size/2; i--) {
-                UT high_mask = UT{0xff} << ((i - 1) * 8);
-                UT low_mask = UT{0xff} << ((size - i) * 8);
-                int shift = (i - size/2) * 16 - 8;
-                result |= (number & high_mask) >> shift;
-                result |= (number & low_mask) << shift;
+        else if constexpr (sizeof(T) == 2)
+            return T(__builtin_bswap16(u16(number)));
+        else if constexpr (sizeof(T) == 4)
+            return T(__builtin_bswap32(u32(number)));
+        else
+            return T(__builtin_bswap64(u64(number)));
+    }
+
+    namespace details {
+        // pshufb control reversing every Size byte group of a 16 byte lane
+        template <std::size_t Size>
+        constexpr std::array<char, 16> bswap_shuffle = [] {
+            std::array<char, 16> to_return{};
+            for (std::size_t i = 0; i < 16; ++i)
+                to_return[i] = char(i / Size * Size + (Size - 1 - i % Size));
+            return to_return;
+        }();
+
+        /*
+         * Byte swaps length values of Size bytes from from into to, which may be the same array. Whole vectors are
+         * shuffled 32 (AVX2) or 16 (SSSE3) bytes at a time, the rest one value at a time; no alignment is assumed.
+         */
+        template <std::size_t Size>
+        void bswap_array(const void* from, void* to, std::size_t length) {
+            using U = unsigned_of_size_t<Size>;
+            const char* in = static_cast<const char*>(from);
+            char* out = static_cast<char*>(to);
+            std::size_t bytes = length * Size;
+            std::size_t i = 0;
+#if defined(__AVX2__)
+            __m128i lane = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bswap_shuffle<Size>.data()));
+            __m256i shuffle = _mm256_broadcastsi128_si256(lane);
+            for (; i + 32 <= bytes; i += 32) {
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_shuffle_epi8(v, shuffle));
+            }
+#elif defined(__SSSE3__)
+            __m128i shuffle = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bswap_shuffle<Size>.data()));
+            for (; i + 16 <= bytes; i += 16) {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_shuffle_epi8(v, shuffle));
+            }
+#endif
+            for (; i < bytes; i += Size) {
+                U value;
+                std::memcpy(&value, in + i, Size);
+                value = ox::bswap(value);
+                std::memcpy(out + i, &value, Size);
             }
-            return std::bit_cast<T>(result);
         }
-    }
+    } // namespace details
 
     inline u32 rotl(u32 x, int shift) {
         shift &= 31;
@@ -81,12 +125,13 @@ namespace ox {
     inline u8 bswap8(u8 data) {return data;}
     inline u32 bswap24(const u8* data) {return (data[0] << 16) | (data[1] << 8) | data[2];}
 
+    // Byte swaps length values of size bytes at data; the size is looked at once, not per value
     void bswap(void* data, int size, int length = 1);
 
     template <std::integral T>
     void bswap(T* data, int length = 1) {
-        for(int i = 0; i < length; i++)
-            data[i] = bswap(data[i]);
+        if constexpr (sizeof(T) > 1)
+            details::bswap_array<sizeof(T)>(data, data, std::size_t(length));
     };
 
     template<scalar_endianable T> requires (!std::is_integral_v<T>)
@@ -100,6 +145,23 @@ namespace ox {
             data[offset].endian_swap();
         }
     }
+
+    // Copies length values from from to to, byte swapped, leaving from untouched
+    template <scalar_endianable T>
+    void bswap_copy(const T* from, T* to, std::size_t length) {
+        if constexpr (sizeof(T) > 1)
+            details::bswap_array<sizeof(T)>(from, to, length);
+        else
+            std::copy_n(from, length, to);
+    }
+
+    template <custom_endianable T>
+    void bswap_copy(const T* from, T* to, std::size_t length) {
+        for (std::size_t i = 0; i < length; ++i) {
+            to[i] = from[i];
+            to[i].endian_swap();
+        }
+    }
 }
 
 #endif
@@ -2,5 +2,7 @@
 #define OX_LIB_GRAPH_H
 
 #include "graph/_dikstra.h"
+#include "graph/_grid_contraction.h"
+#include "graph/_bfs.h"
 
 #endif //OX_LIB_GRAPH_H
@@ -2,6 +2,9 @@
 #define OXLIB_IO_H
 
 #include "../io/_file.h"
+#include "../io/_delimited_view.h"
+#include "../io/_mapped_file.h"
+#include "../io/_chunk_reader.h"
 #include "../io/_istream_container.h"
 #include "../io/_utils.h"
 
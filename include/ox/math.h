@@ -5,5 +5,8 @@
 #include "math/_modulo.h"
 #include "math/_rational.h"
 #include "math/_system_solver.h"
+#include "math/_expression_dag.h"
+#include "math/_linear_system.h"
+#include "math/_linear_recurrence.h"
 
 #endif //OX_LIB_MATH_H
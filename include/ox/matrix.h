@@ -2,5 +2,7 @@
 #define OXLIB_MATRIX_H
 
 #include "containers/_matrix.h"
+#include "containers/_matrix_decomposition.h"
+#include "containers/_sparse_matrix.h"
 
 #endif // OXLIB_MATRIX_H
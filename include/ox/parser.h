@@ -4,5 +4,7 @@
 #define OXLIB_PARSER_H
 
 #include "../parser/_basic_parser.h"
+#include "../parser/_typed_parser.h"
+#include "../parser/_parallel.h"
 
 #endif // OXLIB_PARSER_H
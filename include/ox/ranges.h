@@ -4,6 +4,7 @@
 #include "ranges/_iterator_view.h"
 #include "ranges/_repeat_view.h"
 #include "ranges/_set_views.h"
+#include "ranges/_split_lines_view.h"
 
 namespace oxv = ox::ranges::views;
 
@@ -4,5 +4,6 @@
 #include "../multithreading/threadsafe_queue.h"
 #include "../multithreading/threadpool.h"
 #include "../multithreading/joiner.h"
+#include "../multithreading/parallel_for.h"
 
 #endif // OXLIB_THREADING_H
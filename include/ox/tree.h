@@ -2,5 +2,7 @@
 #define OXLIB_TREE_H
 
 #include "containers/_binary_tree.h"
+#include "containers/_pooled_binary_tree.h"
+#include "containers/_eytzinger_tree.h"
 
 #endif // OXLIB_TREE_H
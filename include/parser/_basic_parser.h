@@ -10,17 +10,37 @@
 #include <cctype>
 #include <expected>
 #include <any>
+#include <array>
+#include <bit>
+#include <cstdint>
 #include <concepts>
 #include <functional>
 #include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string_view>
+#include "_failure.h"
+#include "_packrat.h"
+#include "_scan.h"
 
 namespace ox::parser {
     enum class ParseError {
         bad = 1,
     };
 
-    inline bool debug = false;
-    inline long _indent = 0;
+    /*
+     * Tracing is compiled in only with OXLIB_PARSER_TRACE defined; otherwise every trace statement is discarded at
+     * compile time and debug has no effect. Both the switch and the indentation are per thread, so separate threads
+     * can parse (and trace) concurrently.
+     */
+#ifdef OXLIB_PARSER_TRACE
+    constexpr bool tracing = true;
+#else
+    constexpr bool tracing = false;
+#endif
+    inline thread_local bool debug = false;
+    inline thread_local long _indent = 0;
     inline std::ostream& indent(std::ostream& os) {
         for (long i = 0; i < 4 * _indent; ++i) {
             os << ' ';
@@ -28,6 +48,24 @@ namespace ox::parser {
         return os;
     }
 
+#define PARSE_TRACE(...)                                                                                               \
+    do {                                                                                                               \
+        if constexpr (::ox::parser::tracing) {                                                                         \
+            if (::ox::parser::debug)                                                                                   \
+                std::cout << ::ox::parser::indent << __VA_ARGS__ << std::endl;                                         \
+        }                                                                                                              \
+    } while (false)
+#define PARSE_TRACE_ENTER()                                                                                            \
+    do {                                                                                                               \
+        if constexpr (::ox::parser::tracing)                                                                           \
+            ++::ox::parser::_indent;                                                                                   \
+    } while (false)
+#define PARSE_TRACE_LEAVE()                                                                                            \
+    do {                                                                                                               \
+        if constexpr (::ox::parser::tracing)                                                                           \
+            --::ox::parser::_indent;                                                                                   \
+    } while (false)
+
     using parse_result = std::expected<std::pair<long, std::any>, ParseError>;
 
 #define PARSE_HEADER         [[nodiscard]] parse_result parse(void* ref, std::string_view s) const override
@@ -52,9 +90,35 @@ namespace ox::parser {
     class Parser {
     public:
         PARSE_VIRTUAL_HEADER = 0;
+        // What the parser can start with, used by Or to skip alternatives that cannot match
+        [[nodiscard]] virtual first_set first() const { return first_set::any(); }
         virtual ~Parser() = default;
     };
 
+    /*
+     * While a failure_scope is alive, failing parsers on the same thread report where they failed and what they
+     * expected to its tracker, so a failed parse can be located without tracing.
+     */
+    class failure_scope {
+        failure_tracker tracker;
+        failure_tracker* previous;
+    public:
+        static inline thread_local failure_tracker* active = nullptr;
+
+        failure_scope() : previous(active) { active = &tracker; }
+        ~failure_scope() { active = previous; }
+        failure_scope(const failure_scope&) = delete;
+        failure_scope& operator=(const failure_scope&) = delete;
+
+        // The furthest failure, relative to the input the outermost parser was given
+        [[nodiscard]] parse_failure report(std::string_view input) const { return tracker.report(input); }
+    };
+
+    inline void report_failure(std::string_view s, expectation what) {
+        if (failure_scope::active)
+            failure_scope::active->fail(s.data() + scan::skip_whitespace(s), what);
+    }
+
     class Literal final : public Parser {
         std::string_view match;
         std::function<std::any(void*, std::string_view)> callback;
@@ -67,28 +131,18 @@ namespace ox::parser {
         explicit Literal(const char* _m, const Func& callback) : match{_m}, callback{callback} {};
 
         PARSE_HEADER {
-            if (debug) {
-                std::cout << indent << "Parsing Literal " << std::quoted(match) << " in " << std::quoted(s)
-                          << std::endl;
-            }
-            size_t index = s.find(match);
-            if (index == std::string_view::npos) {
-                if (debug) {
-                    std::cout << indent << "Literal FAILED" << std::endl;
-                }
+            PARSE_TRACE("Parsing Literal " << std::quoted(match) << " in " << std::quoted(s));
+            size_t length = scan::match_literal(s, match);
+            if (length == std::string_view::npos) {
+                PARSE_TRACE("Literal FAILED");
+                report_failure(s, {match, true});
                 return std::unexpected(ParseError::bad);
             }
-            for (int x = 0; size_t(x) < index; ++x) {
-                if (!isspace(s[x])) {
-                    return std::unexpected(ParseError::bad);
-                }
-            }
-            if (debug)
-                std::cout << indent << "FOUND \033[31m" << std::quoted(s.substr(0, index + match.size())) << "\033[0m"
-                          << std::endl;
-            auto x = callback(ref, s.substr(index, match.size()));
-            return std::pair{long(index + match.size()), x};
+            PARSE_TRACE("FOUND \033[31m" << std::quoted(s.substr(0, length)) << "\033[0m");
+            auto x = callback(ref, s.substr(length - match.size(), match.size()));
+            return std::pair{long(length), x};
         }
+        [[nodiscard]] first_set first() const override { return literal_first_set(match); }
         ~Literal() override = default;
 
         Literal operator()(std::function<std::any(void*, std::string_view)> _callback) && {
@@ -115,24 +169,22 @@ namespace ox::parser {
         Int(const Func& _callback) : callback(_callback){};
     public:
         PARSE_HEADER {
-            if (debug)
-                std::cout << indent << "Parsing Int in " << std::quoted(s) << std::endl;
+            PARSE_TRACE("Parsing Int in " << std::quoted(s));
             long l;
-            const char* head = s.begin();
-            while (isspace(*head) && head < s.end())
-                ++head;
-            auto [end, err] = std::from_chars(head, s.end(), l);
-            if (err != std::errc{}) {
-                if (debug)
-                    std::cout << indent << "FAILED TO PARSE INT" << std::endl;
+            size_t head = scan::skip_whitespace(s);
+            size_t length = scan::parse_int(s.substr(head), l);
+            if (length == 0) {
+                PARSE_TRACE("FAILED TO PARSE INT");
+                report_failure(s, {"integer"});
                 return std::unexpected(ParseError::bad);
             }
-            if (debug)
-                std::cout << indent << "FOUND \033[31m" << std::quoted(s.substr(0, end - s.begin())) << "\033[0m"
-                          << std::endl;
+            size_t end = head + length;
+            PARSE_TRACE("FOUND \033[31m" << std::quoted(s.substr(0, end)) << "\033[0m");
             callback(ref, l);
-            return std::pair{end - s.begin(), std::any(l)};
+            return std::pair{long(end), std::any(l)};
         };
+
+        [[nodiscard]] first_set first() const override { return first_set::of("-0123456789"); }
     };
 
     class String : public Parser {
@@ -150,24 +202,14 @@ namespace ox::parser {
         String(std::string_view in_delim) : delim(in_delim), callback([](auto, std::string_view l) { return l; }){};
     public:
         PARSE_HEADER {
-            if (debug)
-                std::cout << indent << "Parsing String in " << std::quoted(s) << std::endl;
-            const char* head;
-            const char* tail;
-            if (delim.empty()) {
-                head = std::find_if_not(s.begin(), s.end(), isspace);
-                tail = std::find_if(head, s.end(), isspace);
-            } else {
-                head = std::find_if_not(s.begin(), s.end(), isspace);
-                tail = std::min(std::find_if(head, s.end(), isspace),
-                                std::search(head, s.end(), delim.begin(), delim.end()));
-            }
-            std::string_view substr = std::string_view(head, tail);
+            PARSE_TRACE("Parsing String in " << std::quoted(s));
+            size_t head = scan::skip_whitespace(s);
+            size_t tail = head + scan::find_word_end(s.substr(head), delim);
+            std::string_view substr = s.substr(head, tail - head);
             callback(ref, substr);
-            if (debug)
-                std::cout << indent << "FOUND \033[31m" << std::quoted(substr) << "\033[0m" << std::endl;
+            PARSE_TRACE("FOUND \033[31m" << std::quoted(substr) << "\033[0m");
 
-            return std::pair{tail - s.begin(), std::any(substr)};
+            return std::pair{long(tail), std::any(substr)};
         };
     };
 
@@ -178,18 +220,15 @@ namespace ox::parser {
         Optional(ParserType&& sub) : sub_parser(new ParserType(sub)){};
     public:
         PARSE_HEADER {
-            if (debug)
-                std::cout << indent << "Parsing Optional in " << std::quoted(s) << std::endl;
+            PARSE_TRACE("Parsing Optional in " << std::quoted(s));
 
             auto res = sub_parser->parse(ref, s);
             if (res) {
-                if (debug)
-                    std::cout << indent << "FOUND OPTIONAL \033[0m" << std::endl;
+                PARSE_TRACE("FOUND OPTIONAL \033[0m");
                 return res;
             }
 
-            if (debug)
-                std::cout << indent << "FAILED OPTIONAL \033[0m" << std::endl;
+            PARSE_TRACE("FAILED OPTIONAL \033[0m");
 
             return std::pair{0, 0};
         };
@@ -228,21 +267,18 @@ namespace ox::parser {
                 tail(_t){};
 
         parse_result parse_with_delim(void* ref, std::string_view s) const {
-            if (debug)
-                std::cout << indent << "Parsing List with delim " << std::quoted(delimiter) << " in " << std::quoted(s)
-                          << std::endl;
+            PARSE_TRACE("Parsing List with delim " << std::quoted(delimiter) << " in " << std::quoted(s));
             size_t pos = 0;
             size_t old_pos = 0;
             long size = 0;
-            ++_indent;
-            while ((pos = s.find(delimiter, old_pos)) != std::string_view::npos) {
+            PARSE_TRACE_ENTER();
+            while ((pos = scan::find(s, delimiter, old_pos)) != s.size()) {
                 callback(ref);
                 std::string_view sub = s.substr(old_pos, pos - old_pos);
                 auto subsize = repeat->parse(ref, sub);
                 if (!subsize) {
-                    --_indent;
-                    if (debug)
-                        std::cout << indent << "Failed to parse LIST" << std::endl;
+                    PARSE_TRACE_LEAVE();
+                    PARSE_TRACE("Failed to parse LIST");
                     return subsize;
                 }
                 size += subsize->first + delimiter.size();
@@ -253,38 +289,34 @@ namespace ox::parser {
                 callback(ref);
                 auto subsize = repeat->parse(ref, sub);
                 if (!subsize) {
-                    --_indent;
+                    PARSE_TRACE_LEAVE();
                     return subsize;
                 }
                 size += subsize->first;
             }
-            --_indent;
-            if (debug)
-                std::cout << indent << "FOUND \033[31m" << std::quoted(s.substr(0, size)) << "\033[0m" << std::endl;
+            PARSE_TRACE_LEAVE();
+            PARSE_TRACE("FOUND \033[31m" << std::quoted(s.substr(0, size)) << "\033[0m");
             return std::pair{size, std::any(nullptr)};
         }
 
         parse_result parse_without_delim(void* ref, std::string_view s) const {
-            if (debug)
-                std::cout << indent << "Parsing List without delim in " << std::quoted(s) << std::endl;
+            PARSE_TRACE("Parsing List without delim in " << std::quoted(s));
             size_t pos = 0;
             long size = 0;
-            ++_indent;
+            PARSE_TRACE_ENTER();
             while (true) {
                 callback(ref);
                 std::string_view sub = s.substr(pos);
                 auto subsize = repeat->parse(ref, sub);
                 if (!subsize) {
-                    if (debug)
-                        std::cout << indent << "Failed to parse LIST" << std::endl;
+                    PARSE_TRACE("Failed to parse LIST");
                     break;
                 }
                 size += subsize->first;
                 pos += subsize->first;
             }
-            --_indent;
-            if (debug)
-                std::cout << indent << "FOUND \033[31m" << std::quoted(s.substr(0, size)) << "\033[0m" << std::endl;
+            PARSE_TRACE_LEAVE();
+            PARSE_TRACE("FOUND \033[31m" << std::quoted(s.substr(0, size)) << "\033[0m");
             return std::pair{size, std::any(nullptr)};
         }
 
@@ -340,59 +372,150 @@ namespace ox::parser {
         }
 
         PARSE_HEADER {
-            if (debug)
-                std::cout << indent << "Parsing Combination in " << std::quoted(s) << std::endl;
-            ++_indent;
+            PARSE_TRACE("Parsing Combination in " << std::quoted(s));
+            PARSE_TRACE_ENTER();
             auto subpart = s;
             long pos = 0;
             std::vector<std::any> subres;
             for (const auto& part : this->parts) {
                 parse_result read = part->parse(ref, subpart);
                 if (!read) {
-                    --_indent;
-                    if (debug)
-                        std::cout << indent << "Failed to Parse Combination" << std::endl;
+                    PARSE_TRACE_LEAVE();
+                    PARSE_TRACE("Failed to Parse Combination");
                     return read;
                 }
                 subres.push_back(read->second);
                 subpart = subpart.substr(read->first);
                 pos += read->first;
             }
-            --_indent;
-            if (debug)
-                std::cout << indent << "FOUND \033[31m" << std::quoted(s.substr(0, pos)) << "\033[0m" << std::endl;
+            PARSE_TRACE_LEAVE();
+            PARSE_TRACE("FOUND \033[31m" << std::quoted(s.substr(0, pos)) << "\033[0m");
             auto x = callback(ref, subres);
             return std::pair{pos, x};
         }
 
+        [[nodiscard]] first_set first() const override {
+            if (this->parts.empty())
+                return first_set::any();
+            first_set to_return = this->parts.front()->first();
+            for (std::size_t i = 1; i < this->parts.size() && to_return.nullable; ++i)
+                to_return = to_return.then(this->parts[i]->first());
+            return to_return;
+        }
+
         ~Combination() override = default;
     };
 
+    /*
+     * Tries its alternatives in order. The first character after whitespace selects, through a table built from the
+     * alternatives' first sets, the ones that can match at all, so the others are not attempted.
+     * The table holds one bit per alternative for the first 64; any after those are always attempted.
+     */
     class Or : public _list<Or> {
-        using _list<Or>::_list;
         friend Or operator|(Parser&& l, Parser&& r);
         template <std::derived_from<Parser> ParserSub>
         friend Or operator|(Or&& l, ParserSub&& r);
+
+        static constexpr std::size_t indexed = 64;
+
+        std::array<std::uint64_t, first_set::end_of_input + 1> dispatch{};
+
+        void index_alternative(std::size_t i) {
+            if (i >= indexed)
+                return;
+            first_set f = this->parts[i]->first();
+            for (std::size_t c = 0; c < dispatch.size(); ++c)
+                if (f.admits(c))
+                    dispatch[c] |= std::uint64_t(1) << i;
+        }
+
+        [[nodiscard]] bool is_viable(std::uint64_t viable, std::size_t i) const {
+            return i >= indexed || (viable >> i) & 1;
+        }
     public:
+        template <typename... ARGS>
+        explicit Or(ARGS&&... rest) : _list<Or>(std::forward<ARGS>(rest)...) {
+            for (std::size_t i = 0; i < this->parts.size(); ++i)
+                index_alternative(i);
+        }
+
+        Or(Or&&) = default;
+
         PARSE_HEADER {
-            if (debug)
-                std::cout << indent << "Parsing Disjoint in " << std::quoted(s) << std::endl;
-            ++_indent;
-            for (const auto& part : this->parts) {
-                auto read = part->parse(ref, s);
-                if (!read)
-                    continue;
-                --_indent;
-                if (debug)
-                    std::cout << indent << "FOUND \033[31m" << std::quoted(s.substr(0, read->first)) << "\033[0m"
-                              << std::endl;
+            PARSE_TRACE("Parsing Disjoint in " << std::quoted(s));
+            PARSE_TRACE_ENTER();
+            std::uint64_t viable = dispatch[first_set::lookahead(s)];
+            auto attempt = [&](std::size_t i) -> parse_result {
+                auto read = this->parts[i]->parse(ref, s);
+                if (read) {
+                    PARSE_TRACE_LEAVE();
+                    PARSE_TRACE("FOUND \033[31m" << std::quoted(s.substr(0, read->first)) << "\033[0m");
+                }
                 return read;
+            };
+            for (std::uint64_t rest = viable; rest != 0; rest &= rest - 1)
+                if (auto read = attempt(std::countr_zero(rest)))
+                    return read;
+            for (std::size_t i = indexed; i < this->parts.size(); ++i)
+                if (auto read = attempt(i))
+                    return read;
+            PARSE_TRACE_LEAVE();
+            if (failure_scope::active) {
+                // the skipped alternatives fail at once, but the failure should still list what they expected
+                for (std::size_t i = 0; i < this->parts.size(); ++i)
+                    if (!is_viable(viable, i))
+                        (void)this->parts[i]->parse(ref, s);
             }
-            --_indent;
-            if (debug)
-                std::cout << indent << "FAILED to find Disjoint" << std::endl;
+            PARSE_TRACE("FAILED to find Disjoint");
             return std::unexpected(ParseError::bad);
         };
+
+        [[nodiscard]] first_set first() const override {
+            first_set to_return;
+            for (const auto& part : this->parts)
+                to_return = to_return | part->first();
+            return to_return;
+        }
+    };
+
+    /*
+     * Packrat mode: while a packrat_scope is alive, Memo parsers on the same thread remember their result for each
+     * position, so backtracking alternatives never reparse the same input twice. Replayed results do not run the
+     * sub-parser's callbacks again.
+     */
+    class packrat_scope {
+        memo_table<parse_result> table;
+        memo_table<parse_result>* previous;
+    public:
+        static inline thread_local memo_table<parse_result>* active = nullptr;
+
+        packrat_scope() : previous(active) { active = &table; }
+        ~packrat_scope() { active = previous; }
+        packrat_scope(const packrat_scope&) = delete;
+        packrat_scope& operator=(const packrat_scope&) = delete;
+    };
+
+    class Memo : public Parser {
+        ParserPoint sub_parser;
+        std::size_t id = next_memo_id();
+    public:
+        template <std::derived_from<Parser> ParserSub>
+        explicit Memo(ParserSub&& sub) : sub_parser(std::make_unique<ParserSub>(std::move(sub))) {}
+
+        Memo(Memo&&) = default;
+
+        PARSE_HEADER {
+            if (!packrat_scope::active)
+                return sub_parser->parse(ref, s);
+            memo_key key{id, s.data(), s.size()};
+            if (auto found = packrat_scope::active->find(key); found != packrat_scope::active->end())
+                return found->second;
+            auto read = sub_parser->parse(ref, s);
+            packrat_scope::active->emplace(key, read);
+            return read;
+        }
+
+        [[nodiscard]] first_set first() const override { return sub_parser->first(); }
     };
 
     template <std::derived_from<Parser> ParserSub1, std::derived_from<Parser> ParserSub2>
@@ -404,6 +527,7 @@ namespace ox::parser {
     template <std::derived_from<Parser> ParserSub>
     Or operator|(Or&& l, ParserSub&& r) {
         l.parts.emplace_back(new ParserSub(std::move(r)));
+        l.index_alternative(l.parts.size() - 1);
         return std::move(l);
     }
 
@@ -0,0 +1,96 @@
+#ifndef OXLIB_PARSER_FAILURE_H
+#define OXLIB_PARSER_FAILURE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace ox::parser {
+    // What a failing parser wanted: a literal text, or a description of a token such as "integer"
+    struct expectation {
+        std::string_view text;
+        bool literal = false;
+
+        bool operator==(const expectation&) const = default;
+    };
+
+    /*
+     * Where a parse failed: the offset into the input of the furthest point any parser failed at, and what the
+     * parsers failing there expected.
+     * Line and column are only worked out from the offset when asked for.
+     */
+    struct parse_failure {
+        std::size_t offset = 0;
+        std::vector<expectation> expected;
+
+        // 1-based line and column of offset in input
+        [[nodiscard]] std::pair<std::size_t, std::size_t> line_column(std::string_view input) const {
+            std::string_view before = input.substr(0, offset);
+            std::size_t line = std::size_t(std::ranges::count(before, '\n')) + 1;
+            std::size_t line_start = before.rfind('\n');
+            std::size_t column = line_start == std::string_view::npos ? offset + 1 : offset - line_start;
+            return {line, column};
+        }
+
+        // "line 3, column 7: expected "red", "green" or integer, found "purple""
+        [[nodiscard]] std::string message(std::string_view input) const {
+            auto [line, column] = line_column(input);
+            std::string to_return =
+                    "line " + std::to_string(line) + ", column " + std::to_string(column) + ": expected ";
+            for (std::size_t i = 0; i < expected.size(); ++i) {
+                if (i)
+                    to_return += i + 1 == expected.size() ? " or " : ", ";
+                if (expected[i].literal)
+                    to_return += '"' + std::string(expected[i].text) + '"';
+                else
+                    to_return += expected[i].text;
+            }
+            std::string_view rest = input.substr(std::min(offset, input.size()));
+            rest = rest.substr(0, std::min(rest.find('\n'), std::size_t(16)));
+            if (rest.empty())
+                return to_return + ", found end of input";
+            return to_return + ", found \"" + std::string(rest) + '"';
+        }
+    };
+
+    /*
+     * Keeps the furthest failure seen during a parse. Parsers only report to it on their failure path, so matching
+     * costs the same as without it. Alternatives that Or or Optional gave up on are reported too, which is what lets
+     * the furthest failure point past them into the input.
+     */
+    class failure_tracker {
+        const char* furthest = nullptr;
+        std::vector<expectation> expected;
+    public:
+        // The parser given the input at position expected what
+        void fail(const char* position, expectation what) {
+            if (furthest && position < furthest)
+                return;
+            if (position > furthest) {
+                furthest = position;
+                expected.clear();
+            }
+            if (std::ranges::find(expected, what) == expected.end())
+                expected.push_back(what);
+        }
+
+        [[nodiscard]] bool failed() const { return furthest != nullptr; }
+
+        // The furthest failure, with its offset relative to input; input must contain every position reported
+        [[nodiscard]] parse_failure report(std::string_view input) const {
+            if (!furthest)
+                return {};
+            return {std::size_t(furthest - input.data()), expected};
+        }
+
+        void clear() {
+            furthest = nullptr;
+            expected.clear();
+        }
+    };
+} // namespace ox::parser
+
+#endif // OXLIB_PARSER_FAILURE_H
@@ -0,0 +1,104 @@
+#ifndef OXLIB_PARSER_PACKRAT_H
+#define OXLIB_PARSER_PACKRAT_H
+
+#include <atomic>
+#include <bitset>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include "_scan.h"
+
+namespace ox::parser {
+    /*
+     * The characters a parser can start with once leading whitespace is skipped, and whether it can succeed without
+     * consuming anything. Parsers that are not analysed report any(): every character, and nullable.
+     */
+    struct first_set {
+        // Index 256 stands for the end of the input
+        static constexpr std::size_t end_of_input = 256;
+
+        std::bitset<257> chars;
+        bool nullable = false;
+
+        static first_set any() {
+            first_set to_return;
+            to_return.chars.set();
+            to_return.nullable = true;
+            return to_return;
+        }
+
+        static first_set of(std::string_view characters) {
+            first_set to_return;
+            for (char c : characters)
+                to_return.chars.set((unsigned char)c);
+            return to_return;
+        }
+
+        // Index into chars of the character s starts with after whitespace
+        static std::size_t lookahead(std::string_view s) {
+            std::size_t head = scan::skip_whitespace(s);
+            return head == s.size() ? end_of_input : (unsigned char)s[head];
+        }
+
+        [[nodiscard]] bool admits(std::size_t c) const { return nullable || chars.test(c); }
+
+        // Either this or other
+        first_set operator|(const first_set& other) const {
+            first_set to_return;
+            to_return.chars = chars | other.chars;
+            to_return.nullable = nullable || other.nullable;
+            return to_return;
+        }
+
+        // This followed by next: next only matters if this can match the empty string
+        [[nodiscard]] first_set then(const first_set& next) const {
+            if (!nullable)
+                return *this;
+            first_set to_return;
+            to_return.chars = chars | next.chars;
+            to_return.nullable = next.nullable;
+            return to_return;
+        }
+    };
+
+    // Literals starting with whitespace can begin after any amount of it, so they are not analysed
+    inline first_set literal_first_set(std::string_view match) {
+        if (match.empty() || scan::is_space(match.front()))
+            return first_set::any();
+        return first_set::of(match.substr(0, 1));
+    }
+
+    /*
+     * Packrat memo tables: the results of memoised parsers keyed by parser id and by the position and length of the
+     * input they were given (the same offset in different slices of the input can parse differently).
+     */
+    struct memo_key {
+        std::size_t id;
+        const char* position;
+        std::size_t length;
+
+        bool operator==(const memo_key&) const = default;
+    };
+
+    struct memo_key_hash {
+        std::size_t operator()(const memo_key& k) const {
+            std::size_t h = std::hash<const char*>()(k.position);
+            h ^= k.id + 0x9e3779b97f4a7c15 + (h << 6) + (h >> 2);
+            h ^= k.length + 0x9e3779b97f4a7c15 + (h << 6) + (h >> 2);
+            return h;
+        }
+    };
+
+    template <typename Result>
+    using memo_table = std::unordered_map<memo_key, Result, memo_key_hash>;
+
+    // Ids of memoised parsers, unique for the lifetime of the program
+    inline std::size_t next_memo_id() {
+        static std::atomic<std::size_t> counter{0};
+        return counter.fetch_add(1, std::memory_order_relaxed);
+    }
+} // namespace ox::parser
+
+#endif // OXLIB_PARSER_PACKRAT_H
@@ -0,0 +1,179 @@
+#ifndef OXLIB_PARSER_PARALLEL_H
+#define OXLIB_PARSER_PARALLEL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <expected>
+#include <functional>
+#include <ranges>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "../multithreading/parallel_for.h"
+#include "_basic_parser.h"
+#include "_scan.h"
+#include "_typed_parser.h"
+
+/*
+ * Parallel parsing of inputs made of independent records separated by a delimiter ("\n" for one record per line).
+ * The input is cut at record boundaries into chunks, every chunk is parsed on the thread_pool or the calling thread
+ * into its own buffer, and the buffers are handed back in input order, so the result is the same as a sequential
+ * List(delimiter, record) whatever the number of chunks. The calling thread parses chunks rather than only waiting,
+ * so these may be called from inside a pool task.
+ * parse_blocks instead takes the input as a range of blocks of whole records, such as an ox::chunk_reader, and parses
+ * each block as it arrives, so that reading the next blocks overlaps with parsing.
+ */
+namespace ox::parser {
+    /*
+     * Cuts input into at most chunks pieces of about equal size, each but the last ending just after a delimiter.
+     * The pieces cover input exactly, in order. delimiter must not be empty.
+     */
+    inline std::vector<std::string_view> split_records(std::string_view input, std::string_view delimiter,
+                                                       std::size_t chunks) {
+        std::vector<std::string_view> to_return;
+        chunks = std::max<std::size_t>(chunks, 1);
+        std::size_t target = input.size() / chunks + 1;
+        std::size_t start = 0;
+        while (start < input.size() && to_return.size() + 1 < chunks) {
+            std::size_t boundary = scan::find(input, delimiter, std::min(start + target, input.size()));
+            if (boundary == input.size())
+                break;
+            boundary += delimiter.size();
+            to_return.push_back(input.substr(start, boundary - start));
+            start = boundary;
+        }
+        to_return.push_back(input.substr(start));
+        return to_return;
+    }
+
+    // Enough chunks per worker that one slow chunk does not leave the others idle
+    inline std::size_t default_chunks() {
+        return 4 * std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    namespace details {
+        /*
+         * Calls f on each record of piece until it returns false. Like List(delimiter, ...), an unended piece also
+         * has a record after its last delimiter, possibly empty, and an either piece when that record is not empty.
+         */
+        template <typename F>
+        bool for_each_record(std::string_view piece, std::string_view delimiter, ListEnding tail, F f) {
+            std::size_t pos = 0;
+            while (true) {
+                std::size_t end = scan::find(piece, delimiter, pos);
+                if (end == piece.size() && tail != ListEnding::unended && pos == piece.size())
+                    return true;
+                if (!f(piece.substr(pos, end - pos)))
+                    return false;
+                if (end == piece.size())
+                    return true;
+                pos = end + delimiter.size();
+            }
+        }
+
+        // Every chunk but the last ends with the delimiter closing its last record
+        inline ListEnding chunk_ending(std::size_t i, std::size_t chunks) {
+            return i + 1 < chunks ? ListEnding::ended : ListEnding::unended;
+        }
+    } // namespace details
+
+    /*
+     * Parses every record of input with record, passing each chunk's own Ref (value initialised) to the callbacks
+     * instead of a shared one, so callbacks need no synchronisation. The Refs are returned in input order for the
+     * caller to merge.
+     */
+    template <typename Ref>
+    std::expected<std::vector<Ref>, ParseError> parse_records(const Parser& record, std::string_view input,
+                                                              thread_pool<std::function<void()>>& pool,
+                                                              std::string_view delimiter = "\n",
+                                                              std::size_t chunks = default_chunks()) {
+        std::vector<std::string_view> pieces = split_records(input, delimiter, chunks);
+        std::vector<Ref> refs(pieces.size());
+        std::vector<char> failed(pieces.size(), false);
+        parallel_for(pool, pieces.size(), [&](std::size_t i) {
+            failed[i] = !details::for_each_record(
+                    pieces[i], delimiter, details::chunk_ending(i, pieces.size()),
+                    [&](std::string_view r) { return bool(record.parse(&refs[i], r)); });
+        });
+        if (std::ranges::find(failed, true) != failed.end())
+            return std::unexpected(ParseError::bad);
+        return refs;
+    }
+
+    // Parses every record of every block with record, giving ref to its callbacks; blocks end with a delimiter or
+    // with the last record of the input
+    template <std::ranges::input_range Blocks>
+    requires std::convertible_to<std::ranges::range_reference_t<Blocks>, std::string_view>
+    std::expected<void, ParseError> parse_blocks(const Parser& record, Blocks&& blocks, void* ref,
+                                                 std::string_view delimiter = "\n") {
+        for (std::string_view block : blocks)
+            if (!details::for_each_record(block, delimiter, ListEnding::either,
+                                          [&](std::string_view r) { return bool(record.parse(ref, r)); }))
+                return std::unexpected(ParseError::bad);
+        return {};
+    }
+
+    namespace typed {
+        /*
+         * The value of every record of input, in input order. Each chunk collects its values into its own buffer
+         * with its own parse_context; callbacks inside record (map) run concurrently and must not share
+         * unsynchronised state.
+         */
+        template <parser P>
+        std::expected<std::vector<parser_value_t<P>>, ParseError>
+        parse_records(const P& record, std::string_view input, thread_pool<std::function<void()>>& pool,
+                      std::string_view delimiter = "\n", std::size_t chunks = default_chunks()) {
+            std::vector<std::string_view> pieces = split_records(input, delimiter, chunks);
+            std::vector<std::vector<parser_value_t<P>>> buffers(pieces.size());
+            std::vector<char> failed(pieces.size(), false);
+            parallel_for(pool, pieces.size(), [&](std::size_t i) {
+                parse_context context{pieces[i]};
+                failed[i] = !parser::details::for_each_record(
+                        pieces[i], delimiter, parser::details::chunk_ending(i, pieces.size()),
+                        [&](std::string_view r) {
+                            auto read = record.parse(r, context);
+                            if (read)
+                                buffers[i].push_back(std::move(read->value));
+                            return bool(read);
+                        });
+            });
+            if (std::ranges::find(failed, true) != failed.end())
+                return std::unexpected(ParseError::bad);
+
+            std::size_t total = 0;
+            for (const auto& buffer : buffers)
+                total += buffer.size();
+            std::vector<parser_value_t<P>> to_return;
+            to_return.reserve(total);
+            for (auto& buffer : buffers)
+                std::ranges::move(buffer, std::back_inserter(to_return));
+            return to_return;
+        }
+
+        // Hands the value of every record of every block to each() in input order; the result is their count
+        template <parser P, std::ranges::input_range Blocks, typename F>
+        requires std::convertible_to<std::ranges::range_reference_t<Blocks>, std::string_view>
+                 && std::invocable<F&, parser_value_t<P>>
+        std::expected<std::size_t, ParseError> parse_blocks(const P& record, Blocks&& blocks, F each,
+                                                            std::string_view delimiter = "\n") {
+            std::size_t count = 0;
+            for (std::string_view block : blocks) {
+                parse_context context{block};
+                bool parsed = parser::details::for_each_record(block, delimiter, ListEnding::either,
+                                                               [&](std::string_view r) {
+                                                                   auto read = record.parse(r, context);
+                                                                   if (!read)
+                                                                       return false;
+                                                                   std::invoke(each, std::move(read->value));
+                                                                   ++count;
+                                                                   return true;
+                                                               });
+                if (!parsed)
+                    return std::unexpected(ParseError::bad);
+            }
+            return count;
+        }
+    } // namespace typed
+} // namespace ox::parser
+
+#endif // OXLIB_PARSER_PARALLEL_H
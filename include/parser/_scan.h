@@ -0,0 +1,233 @@
+#ifndef OXLIB_PARSER_SCAN_H
+#define OXLIB_PARSER_SCAN_H
+
+#include <bit>
+#include <charconv>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+/*
+ * Scanning kernels shared by the parser nodes, usable on any std::string_view.
+ * Whitespace is the C locale set (' ' and '\t' to '\r'). Scans look at 32 (AVX2) or 16 (SSE2) bytes per step once
+ * past the first byte, which answers the common case of no leading whitespace without touching vector registers;
+ * without SSE2 they fall back to scalar loops. Searches return offsets into s, s.size() meaning not found.
+ */
+namespace ox::parser::scan {
+    constexpr bool is_space(char c) { return c == ' ' || (unsigned char)(c - '\t') <= '\r' - '\t'; }
+
+    constexpr bool is_digit(char c) { return (unsigned char)(c - '0') < 10; }
+
+    namespace details {
+#if defined(__AVX2__)
+        constexpr std::size_t lanes = 32;
+        using vector = __m256i;
+
+        inline vector load(const char* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+        inline vector splat(char c) { return _mm256_set1_epi8(c); }
+        inline std::uint32_t mask(vector v) { return std::uint32_t(_mm256_movemask_epi8(v)); }
+        inline vector equal(vector a, vector b) { return _mm256_cmpeq_epi8(a, b); }
+        inline vector either(vector a, vector b) { return _mm256_or_si256(a, b); }
+        inline vector both(vector a, vector b) { return _mm256_and_si256(a, b); }
+
+        inline vector space_mask(vector v) {
+            vector shifted = _mm256_sub_epi8(v, splat('\t'));
+            vector control = equal(_mm256_min_epu8(shifted, splat('\r' - '\t')), shifted);
+            return either(control, equal(v, splat(' ')));
+        }
+
+        inline std::uint32_t space_bits(vector v) { return mask(space_mask(v)); }
+        inline std::uint32_t non_space_bits(vector v) { return mask(equal(space_mask(v), splat(0))); }
+        inline std::uint32_t space_or_bits(vector v, char c) { return mask(either(space_mask(v), equal(v, splat(c)))); }
+
+        // Positions i where p[i] == first and p[i + distance] == last
+        inline std::uint32_t pair_bits(const char* p, std::size_t distance, char first, char last) {
+            return mask(both(equal(load(p), splat(first)), equal(load(p + distance), splat(last))));
+        }
+#elif defined(__SSE2__)
+        constexpr std::size_t lanes = 16;
+        using vector = __m128i;
+
+        inline vector load(const char* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+        inline vector splat(char c) { return _mm_set1_epi8(c); }
+        inline std::uint32_t mask(vector v) { return std::uint32_t(_mm_movemask_epi8(v)); }
+        inline vector equal(vector a, vector b) { return _mm_cmpeq_epi8(a, b); }
+        inline vector either(vector a, vector b) { return _mm_or_si128(a, b); }
+        inline vector both(vector a, vector b) { return _mm_and_si128(a, b); }
+
+        inline vector space_mask(vector v) {
+            vector shifted = _mm_sub_epi8(v, splat('\t'));
+            vector control = equal(_mm_min_epu8(shifted, splat('\r' - '\t')), shifted);
+            return either(control, equal(v, splat(' ')));
+        }
+
+        inline std::uint32_t space_bits(vector v) { return mask(space_mask(v)); }
+        inline std::uint32_t non_space_bits(vector v) { return mask(equal(space_mask(v), splat(0))); }
+        inline std::uint32_t space_or_bits(vector v, char c) { return mask(either(space_mask(v), equal(v, splat(c)))); }
+
+        // Positions i where p[i] == first and p[i + distance] == last
+        inline std::uint32_t pair_bits(const char* p, std::size_t distance, char first, char last) {
+            return mask(both(equal(load(p), splat(first)), equal(load(p + distance), splat(last))));
+        }
+#else
+        // Scalar build: no vector steps are taken
+        constexpr std::size_t lanes = 0;
+        struct vector {};
+
+        inline vector load(const char*) { return {}; }
+        inline std::uint32_t space_bits(vector) { return 0; }
+        inline std::uint32_t non_space_bits(vector) { return 0; }
+        inline std::uint32_t space_or_bits(vector, char) { return 0; }
+        inline std::uint32_t pair_bits(const char*, std::size_t, char, char) { return 0; }
+#endif
+
+        // First offset from i whose byte satisfies wanted (checked one vector at a time by block_mask)
+        template <typename Scalar, typename Block>
+        std::size_t scan_from(std::string_view s, std::size_t i, Scalar wanted, Block block_mask) {
+            if constexpr (lanes > 0) {
+                for (; i + lanes <= s.size(); i += lanes) {
+                    std::uint32_t m = block_mask(load(s.data() + i));
+                    if (m)
+                        return i + std::size_t(std::countr_zero(m));
+                }
+            }
+            for (; i < s.size(); ++i)
+                if (wanted(s[i]))
+                    return i;
+            return s.size();
+        }
+
+        // The value of the 8 ASCII digits at p, or -1 if any of them is not a digit
+        inline std::int64_t eight_digits(const char* p) {
+            std::uint64_t chunk;
+            std::memcpy(&chunk, p, 8);
+            if constexpr (std::endian::native != std::endian::little)
+                chunk = __builtin_bswap64(chunk);
+            if (((chunk & 0xF0F0F0F0F0F0F0F0) | (((chunk + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4))
+                != 0x3333333333333333)
+                return -1;
+            chunk = ((chunk & 0x0F0F0F0F0F0F0F0F) * 2561) >> 8;
+            chunk = ((chunk & 0x00FF00FF00FF00FF) * 6553601) >> 16;
+            return std::int64_t(((chunk & 0x0000FFFF0000FFFF) * 42949672960001) >> 32);
+        }
+    } // namespace details
+
+    // Offset of the first non-whitespace character
+    inline std::size_t skip_whitespace(std::string_view s) {
+        if (s.empty() || !is_space(s[0]))
+            return 0;
+        return details::scan_from(s, 1, [](char c) { return !is_space(c); }, details::non_space_bits);
+    }
+
+    // Offset of the first whitespace character
+    inline std::size_t find_whitespace(std::string_view s) {
+        return details::scan_from(s, 0, is_space, details::space_bits);
+    }
+
+    // Offset of the first occurrence of needle; a vector step keeps only positions matching its first and last byte
+    inline std::size_t find(std::string_view s, std::string_view needle, std::size_t from = 0) {
+        if (needle.size() < 2 || s.size() < from + needle.size()) {
+            std::size_t found = s.find(needle, from);
+            return found == std::string_view::npos ? s.size() : found;
+        }
+        std::size_t i = from;
+        std::size_t distance = needle.size() - 1;
+        for (; details::lanes > 0 && i + details::lanes + distance <= s.size(); i += details::lanes) {
+            std::uint32_t m = details::pair_bits(s.data() + i, distance, needle.front(), needle.back());
+            for (; m; m &= m - 1) {
+                std::size_t candidate = i + std::size_t(std::countr_zero(m));
+                if (std::memcmp(s.data() + candidate + 1, needle.data() + 1, distance - 1) == 0)
+                    return candidate;
+            }
+        }
+        std::size_t found = s.find(needle, i);
+        return found == std::string_view::npos ? s.size() : found;
+    }
+
+    // Offset of the end of the word starting at the beginning of s: the first whitespace or start of delimiter
+    inline std::size_t find_word_end(std::string_view s, std::string_view delimiter) {
+        if (delimiter.empty())
+            return find_whitespace(s);
+        char head = delimiter.front();
+        std::size_t i = 0;
+        while (true) {
+            i = details::scan_from(
+                    s, i, [head](char c) { return c == head || is_space(c); },
+                    [head](details::vector v) { return details::space_or_bits(v, head); });
+            if (i == s.size() || is_space(s[i]) || s.substr(i).starts_with(delimiter))
+                return i;
+            ++i;
+        }
+    }
+
+    // Length of whitespace followed by literal at the start of s, or npos when s does not start that way
+    inline std::size_t match_literal(std::string_view s, std::string_view literal) {
+        // an empty literal matches right away and leaves the whitespace alone
+        if (literal.empty())
+            return 0;
+        std::size_t head = skip_whitespace(s);
+        if (is_space(literal.front())) {
+            // such a literal may begin anywhere within the leading whitespace
+            for (std::size_t start = 0; start <= head; ++start)
+                if (s.substr(start).starts_with(literal))
+                    return start + literal.size();
+            return std::string_view::npos;
+        }
+        if (s.size() - head < literal.size() || std::memcmp(s.data() + head, literal.data(), literal.size()) != 0)
+            return std::string_view::npos;
+        return head + literal.size();
+    }
+
+    /*
+     * Parses a decimal integer (with an optional '-' for signed types) at the start of s into value, returning the
+     * number of characters read, 0 if there is no integer or it does not fit T. Runs of 8 digits are converted
+     * at once; more than 18 digits go through std::from_chars for exact overflow detection.
+     */
+    template <std::integral T>
+    std::size_t parse_int(std::string_view s, T& value) {
+        std::size_t i = 0;
+        bool negative = false;
+        if constexpr (std::is_signed_v<T>) {
+            if (!s.empty() && s[0] == '-') {
+                negative = true;
+                ++i;
+            }
+        }
+        std::size_t first = i;
+        std::uint64_t magnitude = 0;
+        for (; i + 8 <= s.size() && i - first < 16; i += 8) {
+            std::int64_t eight = details::eight_digits(s.data() + i);
+            if (eight < 0)
+                break;
+            magnitude = magnitude * 100000000 + std::uint64_t(eight);
+        }
+        for (; i < s.size() && is_digit(s[i]) && i - first < 18; ++i)
+            magnitude = magnitude * 10 + std::uint64_t(s[i] - '0');
+        if (i == first)
+            return 0;
+        if (i < s.size() && is_digit(s[i])) {
+            auto [end, error] = std::from_chars(s.data(), s.data() + s.size(), value);
+            return error == std::errc{} ? std::size_t(end - s.data()) : 0;
+        }
+        using U = std::make_unsigned_t<T>;
+        if (magnitude > std::uint64_t(std::numeric_limits<U>::max()))
+            return 0;
+        if constexpr (std::is_signed_v<T>) {
+            if (magnitude > std::uint64_t(std::numeric_limits<T>::max()) + negative)
+                return 0;
+            value = negative ? T(U(0) - U(magnitude)) : T(magnitude);
+        } else {
+            value = T(magnitude);
+        }
+        return i;
+    }
+} // namespace ox::parser::scan
+
+#endif // OXLIB_PARSER_SCAN_H
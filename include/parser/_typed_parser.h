@@ -0,0 +1,590 @@
+#ifndef OXLIB_TYPED_PARSER_H
+#define OXLIB_TYPED_PARSER_H
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <array>
+#include <bitset>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include "_basic_parser.h"
+#include "_failure.h"
+#include "_packrat.h"
+#include "_scan.h"
+
+/*
+ * Statically typed parser combinators.
+ * Every parser is a plain value whose parse() returns result<value_type>, the number of characters consumed and
+ * the parsed value, with value_type deduced at compile time: string_views into the input for Literal and String,
+ * integers for Int, tuples for sequences and variants (or the common type) for alternatives. Sub-parsers are held
+ * by value, so a parse performs no heap allocation, virtual call or type erasure.
+ *
+ * GAME  = "Game"_l + Int()
+ * COLOR = "red"_l | "blue"_l | "green"_l
+ * PULL  = List(",", map(Int() + String(","), [](long n, std::string_view color) { ... }))
+ */
+namespace ox::parser::typed {
+    template <typename T>
+    struct success {
+        std::size_t length;
+        T value;
+    };
+
+    template <typename T>
+    using result = std::expected<success<T>, ParseError>;
+
+    // Packrat memo tables of every memoised parser taking part in a parse, one table per parser
+    class packrat_memo {
+        struct table_base {
+            virtual ~table_base() = default;
+        };
+        template <typename T>
+        struct table : table_base {
+            memo_table<result<T>> entries;
+        };
+
+        std::unordered_map<std::size_t, std::unique_ptr<table_base>> tables;
+    public:
+        template <typename T>
+        memo_table<result<T>>& entries(std::size_t id) {
+            auto& slot = tables[id];
+            if (!slot)
+                slot = std::make_unique<table<T>>();
+            return static_cast<table<T>&>(*slot).entries;
+        }
+    };
+
+    // State shared by every parser taking part in one parse of input
+    struct parse_context {
+        std::string_view input;
+        // Memoised parsers only remember results when this is set
+        packrat_memo* memo = nullptr;
+        // Failing parsers report to this when set
+        failure_tracker* failures = nullptr;
+
+        void fail(std::string_view s, expectation what) const {
+            if (failures)
+                failures->fail(s.data() + scan::skip_whitespace(s), what);
+        }
+    };
+
+    template <typename P>
+    concept parser = requires(const P& p, std::string_view s, parse_context& context) {
+        typename P::value_type;
+        { p.parse(s, context) } -> std::same_as<result<typename P::value_type>>;
+    };
+
+    template <parser P>
+    using parser_value_t = typename P::value_type;
+
+    // What p can start with; parsers without a first() member can start with anything
+    template <parser P>
+    first_set first_of(const P& p) {
+        if constexpr (requires { { p.first() } -> std::same_as<first_set>; })
+            return p.first();
+        else
+            return first_set::any();
+    }
+
+    namespace details {
+        struct discard {
+            template <typename T>
+            constexpr void operator()(T&&) const {}
+        };
+
+        template <typename T>
+        using non_void_t = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+        // Callbacks returning void give std::monostate
+        template <typename F, typename T>
+        struct mapped_value {
+            using type = non_void_t<std::invoke_result_t<const F&, T>>;
+        };
+        template <typename F, typename... T>
+        requires(!std::invocable<const F&, std::tuple<T...>>)
+        struct mapped_value<F, std::tuple<T...>> {
+            using type = non_void_t<std::invoke_result_t<const F&, T...>>;
+        };
+
+        // Tuples are spread over the arguments of f unless f takes the tuple itself
+        template <typename F, typename T>
+        constexpr decltype(auto) invoke_mapped(const F& f, T&& value) {
+            if constexpr (std::invocable<const F&, T>)
+                return std::invoke(f, std::forward<T>(value));
+            else
+                return std::apply(f, std::forward<T>(value));
+        }
+
+        // A set of n alternatives, small enough that Or's 257 entry dispatch table stays compact
+        template <std::size_t n>
+        using alternative_mask = std::conditional_t<
+                n <= 8, std::uint8_t,
+                std::conditional_t<n <= 16, std::uint16_t,
+                                   std::conditional_t<n <= 32, std::uint32_t,
+                                                      std::conditional_t<n <= 64, std::uint64_t, std::bitset<n>>>>>;
+
+        template <typename Mask>
+        constexpr bool test(const Mask& mask, std::size_t i) {
+            if constexpr (std::integral<Mask>)
+                return (mask >> i) & 1;
+            else
+                return mask.test(i);
+        }
+
+        template <typename Mask>
+        constexpr void set(Mask& mask, std::size_t i) {
+            if constexpr (std::integral<Mask>)
+                mask = Mask(mask | Mask(1) << i);
+            else
+                mask.set(i);
+        }
+
+        template <typename... T>
+        struct alternative_value {
+            using type = std::variant<T...>;
+        };
+        template <typename T, typename... Rest>
+        requires(std::same_as<T, Rest> && ...)
+        struct alternative_value<T, Rest...> {
+            using type = T;
+        };
+    } // namespace details
+
+    // The literal text, after optional leading whitespace
+    class Literal {
+        std::string_view match;
+    public:
+        using value_type = std::string_view;
+
+        constexpr explicit Literal(std::string_view _match) : match(_match) {}
+
+        [[nodiscard]] result<value_type> parse(std::string_view s, parse_context& context) const {
+            std::size_t length = scan::match_literal(s, match);
+            if (length == std::string_view::npos) {
+                context.fail(s, {match, true});
+                return std::unexpected(ParseError::bad);
+            }
+            return success<value_type>{length, s.substr(length - match.size(), match.size())};
+        }
+
+        [[nodiscard]] first_set first() const { return literal_first_set(match); }
+    };
+
+    namespace literals {
+        constexpr Literal operator""_l(const char* c, std::size_t size) { return Literal({c, size}); }
+    } // namespace literals
+
+    // A decimal integer, after optional leading whitespace
+    template <std::integral T = long>
+    class Int {
+    public:
+        using value_type = T;
+
+        [[nodiscard]] result<value_type> parse(std::string_view s, parse_context& context) const {
+            std::size_t head = scan::skip_whitespace(s);
+            T value;
+            std::size_t length = scan::parse_int(s.substr(head), value);
+            if (length == 0) {
+                context.fail(s, {std::is_signed_v<T> ? "integer" : "non-negative integer"});
+                return std::unexpected(ParseError::bad);
+            }
+            return success<value_type>{head + length, value};
+        }
+
+        [[nodiscard]] first_set first() const {
+            return first_set::of(std::is_signed_v<T> ? "-0123456789" : "0123456789");
+        }
+    };
+
+    // A word: skips leading whitespace and stops at whitespace or at delimiter
+    class String {
+        std::string_view delimiter;
+    public:
+        using value_type = std::string_view;
+
+        constexpr String() = default;
+        constexpr explicit String(std::string_view _delimiter) : delimiter(_delimiter) {}
+
+        [[nodiscard]] result<value_type> parse(std::string_view s, parse_context&) const {
+            std::size_t head = scan::skip_whitespace(s);
+            std::size_t tail = head + scan::find_word_end(s.substr(head), delimiter);
+            return success<value_type>{tail, s.substr(head, tail - head)};
+        }
+    };
+
+    // Never fails: the sub-parser's value, or nullopt and nothing consumed
+    template <parser P>
+    class Optional {
+        P sub_parser;
+    public:
+        using value_type = std::optional<parser_value_t<P>>;
+
+        constexpr explicit Optional(P p) : sub_parser(std::move(p)) {}
+
+        [[nodiscard]] constexpr result<value_type> parse(std::string_view s, parse_context& context) const {
+            auto read = sub_parser.parse(s, context);
+            if (!read)
+                return success<value_type>{0, std::nullopt};
+            return success<value_type>{read->length, std::move(read->value)};
+        }
+    };
+
+    /*
+     * Repetitions of a parser, each value handed to each() as it is parsed; the result is their count.
+     * With a delimiter the input is cut at every occurrence and each piece parsed on its own, as in the dynamic List.
+     */
+    template <parser P, typename F = details::discard>
+    requires std::invocable<const F&, parser_value_t<P>>
+    class List {
+        std::string_view delimiter;
+        P repeat;
+        [[no_unique_address]] F each;
+        ListEnding tail;
+
+        [[nodiscard]] constexpr result<std::size_t> parse_with_delim(std::string_view s,
+                                                                     parse_context& context) const {
+            // as in the dynamic List, the length is what the pieces consumed plus the delimiters, so text a piece
+            // leaves before its delimiter is not counted
+            std::size_t count = 0;
+            std::size_t length = 0;
+            std::size_t old_pos = 0;
+            std::size_t pos;
+            while ((pos = scan::find(s, delimiter, old_pos)) != s.size()) {
+                auto read = repeat.parse(s.substr(old_pos, pos - old_pos), context);
+                if (!read)
+                    return std::unexpected(read.error());
+                std::invoke(each, std::move(read->value));
+                ++count;
+                length += read->length + delimiter.size();
+                old_pos = pos + delimiter.size();
+            }
+            if (tail == ListEnding::unended || (tail == ListEnding::either && old_pos != s.size())) {
+                auto read = repeat.parse(s.substr(old_pos), context);
+                if (!read)
+                    return std::unexpected(read.error());
+                std::invoke(each, std::move(read->value));
+                return success<std::size_t>{length + read->length, count + 1};
+            }
+            return success<std::size_t>{length, count};
+        }
+
+        [[nodiscard]] constexpr result<std::size_t> parse_without_delim(std::string_view s,
+                                                                        parse_context& context) const {
+            std::size_t count = 0;
+            std::size_t pos = 0;
+            while (true) {
+                auto read = repeat.parse(s.substr(pos), context);
+                if (!read || read->length == 0)
+                    break;
+                std::invoke(each, std::move(read->value));
+                ++count;
+                pos += read->length;
+            }
+            return success<std::size_t>{pos, count};
+        }
+    public:
+        using value_type = std::size_t;
+
+        constexpr explicit List(P _repeat, ListEnding _tail = ListEnding::unended) :
+                repeat(std::move(_repeat)), tail(_tail) {}
+        constexpr explicit List(std::string_view _delimiter, P _repeat, ListEnding _tail = ListEnding::unended) :
+                delimiter(_delimiter), repeat(std::move(_repeat)), tail(_tail) {}
+        constexpr List(std::string_view _delimiter, P _repeat, F _each, ListEnding _tail = ListEnding::unended) :
+                delimiter(_delimiter), repeat(std::move(_repeat)), each(std::move(_each)), tail(_tail) {}
+
+        [[nodiscard]] constexpr result<value_type> parse(std::string_view s, parse_context& context) const {
+            if (delimiter.empty())
+                return parse_without_delim(s, context);
+            return parse_with_delim(s, context);
+        }
+    };
+
+    template <parser P>
+    List(P, ListEnding = ListEnding::unended) -> List<P>;
+    template <parser P>
+    List(std::string_view, P, ListEnding = ListEnding::unended) -> List<P>;
+    template <parser P, typename F>
+    List(std::string_view, P, F, ListEnding = ListEnding::unended) -> List<P, F>;
+
+    // Each part in turn, values collected into a tuple
+    template <parser... P>
+    class Combination {
+        template <parser... Q>
+        friend class Combination;
+
+        std::tuple<P...> parts;
+
+        template <std::size_t I, typename... Done>
+        [[nodiscard]] constexpr auto parse_from(std::string_view s, parse_context& context, std::size_t pos,
+                                                Done&&... done) const -> result<std::tuple<parser_value_t<P>...>> {
+            if constexpr (I == sizeof...(P)) {
+                return success<std::tuple<parser_value_t<P>...>>{pos, {std::forward<Done>(done)...}};
+            } else {
+                auto read = std::get<I>(parts).parse(s.substr(pos), context);
+                if (!read)
+                    return std::unexpected(read.error());
+                return parse_from<I + 1>(s, context, pos + read->length, std::forward<Done>(done)...,
+                                         std::move(read->value));
+            }
+        }
+    public:
+        using value_type = std::tuple<parser_value_t<P>...>;
+
+        constexpr explicit Combination(P... p) : parts(std::move(p)...) {}
+        constexpr explicit Combination(std::tuple<P...> p) : parts(std::move(p)) {}
+
+        [[nodiscard]] constexpr result<value_type> parse(std::string_view s, parse_context& context) const {
+            return parse_from<0>(s, context, 0);
+        }
+
+        [[nodiscard]] first_set first() const {
+            return std::apply(
+                    [](const auto& head, const auto&... rest) {
+                        first_set to_return = first_of(head);
+                        ((to_return = to_return.nullable ? to_return.then(first_of(rest)) : to_return), ...);
+                        return to_return;
+                    },
+                    parts);
+        }
+
+        template <parser Q>
+        [[nodiscard]] constexpr Combination<P..., Q> then(Q q) && {
+            return Combination<P..., Q>(std::tuple_cat(std::move(parts), std::tuple<Q>(std::move(q))));
+        }
+    };
+
+    /*
+     * The first alternative that matches; the value is their common type if they all agree, a variant otherwise.
+     * The character after leading whitespace selects, through a table built from the alternatives' first sets,
+     * which alternatives are attempted at all.
+     */
+    template <parser... P>
+    class Or {
+        template <parser... Q>
+        friend class Or;
+
+        using alternatives = details::alternative_mask<sizeof...(P)>;
+
+        std::tuple<P...> parts;
+        std::array<alternatives, first_set::end_of_input + 1> dispatch{};
+
+        void index_alternatives() {
+            std::array<first_set, sizeof...(P)> firsts =
+                    std::apply([](const auto&... p) { return std::array<first_set, sizeof...(P)>{first_of(p)...}; },
+                               parts);
+            for (std::size_t c = 0; c < dispatch.size(); ++c)
+                for (std::size_t i = 0; i < sizeof...(P); ++i)
+                    if (firsts[i].admits(c))
+                        details::set(dispatch[c], i);
+        }
+    public:
+        using value_type = typename details::alternative_value<parser_value_t<P>...>::type;
+    private:
+        // The skipped alternatives fail at once, but the failure should still list what they expected
+        template <std::size_t... I>
+        void report_skipped(std::string_view s, parse_context& context, const alternatives& viable,
+                            std::index_sequence<I...>) const {
+            ((details::test(viable, I) ? void() : void(std::get<I>(parts).parse(s, context))), ...);
+        }
+
+        template <std::size_t I>
+        [[nodiscard]] result<value_type> parse_from(std::string_view s, parse_context& context,
+                                                    const alternatives& viable) const {
+            if constexpr (I == sizeof...(P)) {
+                if (context.failures)
+                    report_skipped(s, context, viable, std::index_sequence_for<P...>());
+                return std::unexpected(ParseError::bad);
+            } else {
+                if (!details::test(viable, I))
+                    return parse_from<I + 1>(s, context, viable);
+                auto read = std::get<I>(parts).parse(s, context);
+                if (!read)
+                    return parse_from<I + 1>(s, context, viable);
+                if constexpr (std::same_as<value_type, parser_value_t<std::tuple_element_t<I, std::tuple<P...>>>>)
+                    return success<value_type>{read->length, std::move(read->value)};
+                else
+                    return success<value_type>{read->length,
+                                               value_type(std::in_place_index<I>, std::move(read->value))};
+            }
+        }
+    public:
+        explicit Or(P... p) : parts(std::move(p)...) { index_alternatives(); }
+        explicit Or(std::tuple<P...> p) : parts(std::move(p)) { index_alternatives(); }
+
+        [[nodiscard]] result<value_type> parse(std::string_view s, parse_context& context) const {
+            return parse_from<0>(s, context, dispatch[first_set::lookahead(s)]);
+        }
+
+        [[nodiscard]] first_set first() const {
+            return std::apply([](const auto&... p) { return (first_of(p) | ...); }, parts);
+        }
+
+        template <parser Q>
+        [[nodiscard]] Or<P..., Q> otherwise(Q q) && {
+            return Or<P..., Q>(std::tuple_cat(std::move(parts), std::tuple<Q>(std::move(q))));
+        }
+    };
+
+    // Replaces the value of p by f(value), spreading tuples over f's arguments
+    template <parser P, typename F>
+    class Map {
+        P sub_parser;
+        [[no_unique_address]] F f;
+    public:
+        using value_type = typename details::mapped_value<F, parser_value_t<P>>::type;
+
+        constexpr Map(P p, F _f) : sub_parser(std::move(p)), f(std::move(_f)) {}
+
+        [[nodiscard]] constexpr result<value_type> parse(std::string_view s, parse_context& context) const {
+            auto read = sub_parser.parse(s, context);
+            if (!read)
+                return std::unexpected(read.error());
+            if constexpr (std::is_void_v<decltype(details::invoke_mapped(f, std::move(read->value)))>) {
+                details::invoke_mapped(f, std::move(read->value));
+                return success<value_type>{read->length, {}};
+            } else {
+                return success<value_type>{read->length, details::invoke_mapped(f, std::move(read->value))};
+            }
+        }
+
+        [[nodiscard]] first_set first() const { return first_of(sub_parser); }
+    };
+
+    template <parser P, typename F>
+    constexpr Map<P, F> map(P p, F f) {
+        return {std::move(p), std::move(f)};
+    }
+
+    template <typename T>
+    struct is_combination : std::false_type {};
+    template <typename... P>
+    struct is_combination<Combination<P...>> : std::true_type {};
+
+    template <typename T>
+    struct is_or : std::false_type {};
+    template <typename... P>
+    struct is_or<Or<P...>> : std::true_type {};
+
+    template <parser L, parser R>
+    constexpr auto operator+(L l, R r) {
+        if constexpr (is_combination<L>::value)
+            return std::move(l).then(std::move(r));
+        else
+            return Combination<L, R>(std::move(l), std::move(r));
+    }
+
+    template <parser L, parser R>
+    constexpr auto operator|(L l, R r) {
+        if constexpr (is_or<L>::value)
+            return std::move(l).otherwise(std::move(r));
+        else
+            return Or<L, R>(std::move(l), std::move(r));
+    }
+
+    template <parser P>
+    constexpr Optional<P> operator!(P p) {
+        return Optional<P>(std::move(p));
+    }
+
+    /*
+     * Instrumented wrapper printing what p is given and what it matched, nested like the dynamic parser's trace.
+     * Tracing is opt-in per parser, so grammars that are not wrapped contain no tracing code at all.
+     */
+    template <parser P>
+    class Traced {
+        P sub_parser;
+        std::string_view name;
+    public:
+        using value_type = parser_value_t<P>;
+
+        constexpr Traced(P p, std::string_view _name) : sub_parser(std::move(p)), name(_name) {}
+
+        [[nodiscard]] result<value_type> parse(std::string_view s, parse_context& context) const {
+            std::cout << indent << "Parsing " << name << " in " << std::quoted(s) << std::endl;
+            ++_indent;
+            auto read = sub_parser.parse(s, context);
+            --_indent;
+            if (read)
+                std::cout << indent << "FOUND \033[31m" << std::quoted(s.substr(0, read->length)) << "\033[0m"
+                          << std::endl;
+            else
+                std::cout << indent << name << " FAILED" << std::endl;
+            return read;
+        }
+
+        [[nodiscard]] first_set first() const { return first_of(sub_parser); }
+    };
+
+    template <parser P>
+    constexpr Traced<P> traced(P p, std::string_view name) {
+        return {std::move(p), name};
+    }
+
+    /*
+     * Packrat memoisation of p: when the parse is given a packrat_memo, the result at each position is computed once
+     * and replayed when backtracking alternatives come back to it, keeping nested grammars linear.
+     * Replayed values are copies, and callbacks inside p (map) do not run again.
+     */
+    template <parser P>
+    class Memoized {
+        P sub_parser;
+        std::size_t id = next_memo_id();
+    public:
+        using value_type = parser_value_t<P>;
+
+        explicit Memoized(P p) : sub_parser(std::move(p)) {}
+
+        [[nodiscard]] result<value_type> parse(std::string_view s, parse_context& context) const {
+            if (!context.memo)
+                return sub_parser.parse(s, context);
+            auto& entries = context.memo->entries<value_type>(id);
+            memo_key key{id, s.data(), s.size()};
+            if (auto found = entries.find(key); found != entries.end())
+                return found->second;
+            auto read = sub_parser.parse(s, context);
+            entries.emplace(key, read);
+            return read;
+        }
+
+        [[nodiscard]] first_set first() const { return first_of(sub_parser); }
+    };
+
+    template <parser P>
+    Memoized<P> memoize(P p) {
+        return Memoized<P>(std::move(p));
+    }
+
+    // Parses the start of input with p
+    template <parser P>
+    result<parser_value_t<P>> parse(const P& p, std::string_view input) {
+        parse_context context{input};
+        return p.parse(input, context);
+    }
+
+    // As above in packrat mode, memoised parsers sharing memo
+    template <parser P>
+    result<parser_value_t<P>> parse(const P& p, std::string_view input, packrat_memo& memo) {
+        parse_context context{input, &memo};
+        return p.parse(input, context);
+    }
+
+    // As above, failing parsers reporting to failures so that failures.report(input) locates a failed parse
+    template <parser P>
+    result<parser_value_t<P>> parse(const P& p, std::string_view input, failure_tracker& failures) {
+        parse_context context{input, nullptr, &failures};
+        return p.parse(input, context);
+    }
+} // namespace ox::parser::typed
+
+#endif // OXLIB_TYPED_PARSER_H
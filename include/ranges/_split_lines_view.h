@@ -0,0 +1,194 @@
+#ifndef OX_LIB_SPLIT_LINES_VIEW_H
+#define OX_LIB_SPLIT_LINES_VIEW_H
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <ranges>
+#include <string_view>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace ox::ranges {
+    namespace details {
+        // Bit i set when p[i] == c, for the 64 bytes at p
+        inline std::uint64_t separator_bits(const char* p, char c) {
+#if defined(__AVX2__)
+            __m256i wanted = _mm256_set1_epi8(c);
+            auto bits = [&](const char* q) {
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(q));
+                return std::uint64_t(std::uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, wanted))));
+            };
+            return bits(p) | bits(p + 32) << 32;
+#elif defined(__SSE2__)
+            __m128i wanted = _mm_set1_epi8(c);
+            auto bits = [&](const char* q) {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(q));
+                return std::uint64_t(std::uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(v, wanted))));
+            };
+            return bits(p) | bits(p + 16) << 16 | bits(p + 32) << 32 | bits(p + 48) << 48;
+#else
+            std::uint64_t to_return = 0;
+            for (std::size_t i = 0; i < 64; ++i)
+                to_return |= std::uint64_t(p[i] == c) << i;
+            return to_return;
+#endif
+        }
+    } // namespace details
+
+    /*
+     * The pieces of a contiguous char buffer between occurrences of a separator, as string_views into the buffer.
+     * Separators are located 64 bytes at a time into a bit mask that the iterator keeps, so short lines cost a bit
+     * scan each rather than a search call each.
+     * In line mode (split_lines) a '\r' before the separator is dropped with it, and a final separator does not open
+     * an empty last line; the last line need not end with a separator. Otherwise (split_on) every piece is kept,
+     * including an empty one after a final separator. An empty buffer has no pieces.
+     */
+    class split_lines_view : public std::ranges::view_interface<split_lines_view> {
+        std::string_view buffer;
+        char separator = '\n';
+        bool line_mode = true;
+    public:
+        class iterator {
+            static constexpr std::size_t past_the_end = std::size_t(-1);
+
+            const char* data = nullptr;
+            std::size_t size = 0;
+            // the current piece is [start, stop)
+            std::size_t start = past_the_end;
+            std::size_t stop = 0;
+            // bytes before scanned have been searched; bits holds the separators not yet reached in the 64 before it
+            std::size_t scanned = 0;
+            std::uint64_t bits = 0;
+            char separator = '\n';
+            bool line_mode = true;
+
+            // Sets stop to the first separator at or after start, or to size
+            void find_stop() {
+                while (!bits) {
+                    if (scanned + 64 > size) {
+                        // the tail is shorter than a block
+                        std::size_t from = std::max(start, scanned);
+                        std::size_t found = std::string_view(data + from, size - from).find(separator);
+                        stop = found == std::string_view::npos ? size : from + found;
+                        return;
+                    }
+                    bits = details::separator_bits(data + scanned, separator);
+                    scanned += 64;
+                }
+                stop = scanned - 64 + std::size_t(std::countr_zero(bits));
+                bits &= bits - 1;
+            }
+        public:
+            using value_type = std::string_view;
+            using difference_type = std::ptrdiff_t;
+            using iterator_concept = std::forward_iterator_tag;
+
+            iterator() = default;
+            iterator(const split_lines_view& parent, bool at_end) :
+                    data(parent.buffer.data()),
+                    size(parent.buffer.size()),
+                    separator(parent.separator),
+                    line_mode(parent.line_mode) {
+                if (at_end || size == 0)
+                    return;
+                start = 0;
+                find_stop();
+            }
+
+            std::string_view operator*() const {
+                std::size_t length = stop - start;
+                if (line_mode && length && data[stop - 1] == '\r')
+                    --length;
+                return {data + start, length};
+            }
+
+            iterator& operator++() {
+                if (stop == size || (line_mode && stop + 1 == size)) {
+                    start = past_the_end;
+                    return *this;
+                }
+                start = stop + 1;
+                find_stop();
+                return *this;
+            }
+
+            iterator operator++(int) {
+                auto temp = *this;
+                ++*this;
+                return temp;
+            }
+
+            friend bool operator==(const iterator& x, const iterator& y) { return x.start == y.start; }
+        };
+
+        split_lines_view() = default;
+        split_lines_view(std::string_view _buffer, char _separator, bool _line_mode) :
+                buffer(_buffer), separator(_separator), line_mode(_line_mode) {}
+
+        [[nodiscard]] iterator begin() const { return {*this, false}; }
+        [[nodiscard]] iterator end() const { return {*this, true}; }
+    };
+
+    namespace details {
+        template <typename R>
+        concept char_buffer = std::ranges::contiguous_range<R> && std::ranges::sized_range<R>
+                              && std::ranges::borrowed_range<R>
+                              && std::same_as<std::ranges::range_value_t<R>, char>;
+
+        template <char_buffer R>
+        std::string_view as_buffer(R&& r) {
+            return {std::ranges::data(r), std::size_t(std::ranges::size(r))};
+        }
+
+        struct split_lines_adaptor {
+            template <char_buffer R>
+            [[nodiscard]] split_lines_view operator()(R&& r) const {
+                return {as_buffer(std::forward<R>(r)), '\n', true};
+            }
+        };
+
+        template <char_buffer R>
+        split_lines_view operator|(R&& r, const split_lines_adaptor& a) {
+            return a(std::forward<R>(r));
+        }
+
+        struct split_on_closure {
+            char separator;
+
+            template <char_buffer R>
+            [[nodiscard]] split_lines_view operator()(R&& r) const {
+                return {as_buffer(std::forward<R>(r)), separator, false};
+            }
+        };
+
+        template <char_buffer R>
+        split_lines_view operator|(R&& r, const split_on_closure& a) {
+            return a(std::forward<R>(r));
+        }
+
+        struct split_on_adaptor {
+            template <char_buffer R>
+            [[nodiscard]] split_lines_view operator()(R&& r, char separator) const {
+                return {as_buffer(std::forward<R>(r)), separator, false};
+            }
+
+            [[nodiscard]] constexpr split_on_closure operator()(char separator) const { return {separator}; }
+        };
+    } // namespace details
+
+    namespace views {
+        constexpr inline details::split_lines_adaptor split_lines;
+        constexpr inline details::split_on_adaptor split_on;
+    } // namespace views
+} // namespace ox::ranges
+
+// The pieces point into the buffer, not into the view
+template <>
+inline constexpr bool std::ranges::enable_borrowed_range<ox::ranges::split_lines_view> = true;
+
+#endif // OX_LIB_SPLIT_LINES_VIEW_H
@@ -0,0 +1,187 @@
+#include "math/_expression_dag.h"
+#include <functional>
+
+namespace ox::system {
+    symbol_id symbol_table::intern(std::string_view name) {
+        auto [it, inserted] = ids.try_emplace(std::string(name), symbol_id(names.size()));
+        if (inserted)
+            names.push_back(&it->first);
+        return it->second;
+    }
+
+    symbol_id symbol_table::find(std::string_view name) const {
+        auto it = ids.find(std::string(name));
+        return it == ids.end() ? -1 : it->second;
+    }
+
+    std::size_t expr_node_hash::operator()(const expr_node& n) const {
+        std::size_t h = std::hash<long>()(n.value);
+        h ^= std::hash<std::uint64_t>()((std::uint64_t(std::uint32_t(n.left)) << 32) | std::uint32_t(n.right))
+           + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+        h ^= (std::size_t(n.type) << 8 | std::size_t(n.oper)) + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+        return h;
+    }
+
+    expr_id expression_dag::intern(const expr_node& n) {
+        auto [it, inserted] = interned.try_emplace(n, expr_id(nodes.size()));
+        if (inserted)
+            nodes.push_back(n);
+        return it->second;
+    }
+
+    expr_id expression_dag::constant(long value) {
+        return intern({.type = expr_node::kind::constant, .value = value});
+    }
+
+    expr_id expression_dag::symbol(std::string_view name) {
+        return intern({.type = expr_node::kind::symbol, .value = symbols.intern(name)});
+    }
+
+    expr_id expression_dag::make(op oper, expr_id left, expr_id right) {
+        return intern({.type = expr_node::kind::operation, .oper = oper, .left = left, .right = right});
+    }
+
+    expr_id expression_dag::from_tree(const math_tree_node& tree) {
+        return std::visit(ox::overload{[this](long l) { return constant(l); },
+                                       [this](const std::string& s) { return symbol(s); },
+                                       [this, &tree](op o) {
+                                           expr_id left = from_tree(tree.get_left_child());
+                                           expr_id right = from_tree(tree.get_right_child());
+                                           return make(o, left, right);
+                                       }},
+                          tree.value);
+    }
+
+    math_tree_node expression_dag::to_tree(expr_id id) const {
+        const expr_node& n = nodes[id];
+        switch (n.type) {
+            case expr_node::kind::constant:
+                return math_tree_node(n.value);
+            case expr_node::kind::symbol:
+                return math_tree_node(symbols.name(symbol_id(n.value)));
+            default:
+                math_tree_node to_return(n.oper);
+                to_return.emplace_left(to_tree(n.left));
+                to_return.emplace_right(to_tree(n.right));
+                return to_return;
+        }
+    }
+
+    expr_id expression_dag::reduce(expr_id id) {
+        if (nodes[id].type != expr_node::kind::operation)
+            return id;
+        if (reduced.size() <= std::size_t(id))
+            reduced.resize(nodes.size(), no_expr);
+        if (reduced[id] != no_expr)
+            return reduced[id];
+
+        // copied, since interning new nodes may reallocate
+        expr_node n = nodes[id];
+        expr_id left = reduce(n.left);
+        expr_id right = reduce(n.right);
+        auto is_value = [this](expr_id e, long v) { return is_constant(e) && nodes[e].value == v; };
+
+        expr_id result;
+        if (is_constant(left) && is_constant(right) && !(n.oper == op::DIV && nodes[right].value == 0)) {
+            result = constant(op_fun[int8_t(n.oper)](nodes[left].value, nodes[right].value));
+        } else if (n.oper == op::MUL && (is_value(left, 0) || is_value(right, 0))) {
+            result = constant(0);
+        } else if (n.oper == op::PLUS && is_value(left, 0)) {
+            result = right;
+        } else if ((n.oper == op::PLUS || n.oper == op::MIN) && is_value(right, 0)) {
+            result = left;
+        } else if (n.oper == op::MUL && is_value(left, 1)) {
+            result = right;
+        } else if ((n.oper == op::MUL || n.oper == op::DIV) && is_value(right, 1)) {
+            result = left;
+        } else if ((n.oper == op::MIN || n.oper == op::PLUS) && is_constant(right) && nodes[right].value < 0) {
+            result = make(inv_op[int8_t(n.oper)], left, constant(-nodes[right].value));
+        } else {
+            result = make(n.oper, left, right);
+        }
+
+        reduced.resize(nodes.size(), no_expr);
+        reduced[id] = result;
+        reduced[result] = result;
+        return result;
+    }
+
+    expr_id expression_dag::expand_multiplication(expr_id id) {
+        if (nodes[id].type != expr_node::kind::operation)
+            return id;
+        if (expanded.size() <= std::size_t(id))
+            expanded.resize(nodes.size(), no_expr);
+        if (expanded[id] != no_expr)
+            return expanded[id];
+
+        expr_node n = nodes[id];
+        expr_id left = expand_multiplication(n.left);
+        expr_id right = expand_multiplication(n.right);
+        auto is_sum = [this](expr_id e) { return is_operation(e, op::PLUS) || is_operation(e, op::MIN); };
+
+        expr_id result;
+        if (n.oper == op::MUL && (is_sum(left) || is_sum(right))) {
+            // the multiplier is shared by both products rather than copied
+            expr_id multiplier = is_sum(right) ? left : right;
+            expr_node term = nodes[is_sum(right) ? right : left];
+            expr_id term_left = expand_multiplication(make(op::MUL, multiplier, term.left));
+            expr_id term_right = expand_multiplication(make(op::MUL, multiplier, term.right));
+            result = make(term.oper, term_left, term_right);
+        } else {
+            result = make(n.oper, left, right);
+        }
+
+        expanded.resize(nodes.size(), no_expr);
+        expanded[id] = result;
+        return result;
+    }
+
+    bool expression_dag::contains(expr_id id, symbol_id symbol) {
+        const expr_node& n = nodes[id];
+        if (n.type == expr_node::kind::constant)
+            return false;
+        if (n.type == expr_node::kind::symbol)
+            return n.value == symbol;
+
+        std::uint64_t key = (std::uint64_t(std::uint32_t(id)) << 32) | std::uint32_t(symbol);
+        if (auto it = contains_memo.find(key); it != contains_memo.end())
+            return it->second;
+        bool result = contains(n.left, symbol) || contains(n.right, symbol);
+        contains_memo.emplace(key, result);
+        return result;
+    }
+
+    void expression_dag::terms_imp(expr_id id, op sign, std::vector<std::pair<expr_id, op>>& out) const {
+        const expr_node& n = nodes[id];
+        if (is_operation(id, op::PLUS) || is_operation(id, op::MIN)) {
+            terms_imp(n.left, sign, out);
+            terms_imp(n.right, n.oper == op::MIN ? inv_op[int8_t(sign)] : sign, out);
+        } else if (!(n.type == expr_node::kind::constant && n.value == 0)) {
+            out.emplace_back(id, sign);
+        }
+    }
+
+    std::vector<std::pair<expr_id, op>> expression_dag::terms(expr_id id) const {
+        std::vector<std::pair<expr_id, op>> to_return;
+        terms_imp(id, op::PLUS, to_return);
+        return to_return;
+    }
+
+    void expression_dag::print(expr_id id, std::ostream& os) const {
+        const expr_node& n = nodes[id];
+        switch (n.type) {
+            case expr_node::kind::constant:
+                os << n.value;
+                break;
+            case expr_node::kind::symbol:
+                os << symbols.name(symbol_id(n.value));
+                break;
+            default:
+                os << '(';
+                print(n.left, os);
+                os << op_str[int8_t(n.oper)];
+                print(n.right, os);
+                os << ')';
+        }
+    }
+} // namespace ox::system
@@ -0,0 +1,133 @@
+#include <ox/math.h>
+#include <ox/tree.h>
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+/*
+ * Distributes (a0 + ... + an) * (b0 + ... + bm) into a sum of products and tears the tree down: on the heap
+ * allocated math_tree_node with the solver's own ox::system::expand_multiplication, and on a pooled_binary_tree
+ * with pooled_expand_multiplication below, the same rewrite on index links. The solver itself still works on
+ * math_tree_node, so this measures what the pooled layout would save it, not the solver as shipped.
+ * The copy workload repeatedly deep copies the distributed tree, as reduce and factor do with subtrees.
+ */
+
+using namespace ox::system;
+using pooled_math_tree = ox::pooled_binary_tree<node_type>;
+using node_index = pooled_math_tree::index;
+
+constexpr int terms = 24;
+constexpr int repetitions = 20;
+
+math_tree_node heap_sum(char base, int n) {
+    math_tree_node tree(std::string(1, base) + "0");
+    for (int i = 1; i < n; ++i) {
+        math_tree_node next(op::PLUS);
+        next.emplace_left(std::move(tree));
+        next.emplace_right(std::string(1, base) + std::to_string(i));
+        tree = std::move(next);
+    }
+    return tree;
+}
+
+node_index pooled_sum(pooled_math_tree& tree, char base, int n) {
+    node_index head = tree.emplace(std::string(1, base) + "0");
+    for (int i = 1; i < n; ++i) {
+        node_index next = tree.emplace(op::PLUS);
+        tree.set_left(next, head);
+        tree.emplace_right(next, std::string(1, base) + std::to_string(i));
+        head = next;
+    }
+    return head;
+}
+
+bool is_sum(const node_type& v) {
+    return v == node_type(op::PLUS) || v == node_type(op::MIN);
+}
+
+bool pooled_expand_multiplication(pooled_math_tree& tree, node_index i) {
+    if (tree.value(i) == node_type(op::MUL)
+        && (is_sum(tree.value(tree.get_right_child(i))) || is_sum(tree.value(tree.get_left_child(i))))) {
+        bool right_sum = is_sum(tree.value(tree.get_right_child(i)));
+        node_index multiplier = right_sum ? tree.get_left_child(i) : tree.get_right_child(i);
+        node_index term = right_sum ? tree.get_right_child(i) : tree.get_left_child(i);
+
+        node_index left = tree.emplace(op::MUL);
+        tree.set_left(left, tree.copy_subtree(multiplier));
+        tree.set_right(left, tree.get_left_child(term));
+        node_index right = tree.emplace(op::MUL);
+        tree.set_left(right, tree.copy_subtree(multiplier));
+        tree.set_right(right, tree.get_right_child(term));
+
+        tree.value(i) = tree.value(term);
+        tree.set_left(i, left);
+        tree.set_right(i, right);
+        return true;
+    }
+    if (std::holds_alternative<op>(tree.value(i))) {
+        return pooled_expand_multiplication(tree, tree.get_left_child(i))
+            || pooled_expand_multiplication(tree, tree.get_right_child(i));
+    }
+    return false;
+}
+
+template <typename F>
+long time_ms(F f) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repetitions; ++i)
+        f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+}
+
+math_tree_node heap_distributed() {
+    math_tree_node tree(op::MUL);
+    tree.emplace_left(heap_sum('a', terms));
+    tree.emplace_right(heap_sum('b', terms));
+    while (expand_multiplication(tree))
+        ;
+    return tree;
+}
+
+void pooled_distributed(pooled_math_tree& tree) {
+    node_index root = tree.emplace_root(op::MUL);
+    tree.set_left(root, pooled_sum(tree, 'a', terms));
+    tree.set_right(root, pooled_sum(tree, 'b', terms));
+    while (pooled_expand_multiplication(tree, root))
+        ;
+}
+
+int main() {
+    // both sides build, distribute and destroy the tree; nodes are counted outside the timed loops
+    long heap = time_ms([]() { math_tree_node tree = heap_distributed(); });
+    long pooled = time_ms([]() {
+        pooled_math_tree tree;
+        pooled_distributed(tree);
+    });
+
+    math_tree counted{heap_distributed()};
+    std::size_t heap_nodes = std::distance(counted.begin(), counted.end());
+    pooled_math_tree pooled_counted;
+    pooled_distributed(pooled_counted);
+    pooled_counted.compact();
+    std::size_t pooled_nodes = pooled_counted.size();
+
+    math_tree_node heap_tree = heap_distributed();
+    long heap_copy = time_ms([&heap_tree]() {
+        for (int i = 0; i < 100; ++i) {
+            math_tree_node cpy(heap_tree);
+        }
+    });
+
+    pooled_math_tree pooled_tree(heap_tree);
+    long pooled_copy = time_ms([&pooled_tree]() {
+        for (int i = 0; i < 100; ++i) {
+            pooled_math_tree cpy(pooled_tree);
+        }
+    });
+
+    printf("distribute heap   binary_tree_node: %5ld ms (%zu nodes)\n", heap, heap_nodes);
+    printf("distribute pooled_binary_tree:      %5ld ms (%zu nodes)\n", pooled, pooled_nodes);
+    printf("copy       heap   binary_tree_node: %5ld ms\n", heap_copy);
+    printf("copy       pooled_binary_tree:      %5ld ms\n", pooled_copy);
+}
@@ -0,0 +1,44 @@
+#include <ox/bytes.h>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+/*
+ * Byte swaps 256 MB of 16, 32 and 64 bit values in place with ox::bswap(T*, n), and copies them swapped with
+ * ox::bswap_copy, against a loop swapping one value at a time through the runtime size switch it used to take.
+ * Build with -mssse3 or -mavx2 to get the shuffle kernels.
+ */
+
+constexpr std::size_t bytes = std::size_t(256) << 20;
+
+template <typename F>
+double seconds(F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+template <typename T>
+void run(const char* name) {
+    std::vector<T> values(bytes / sizeof(T));
+    for (std::size_t i = 0; i < values.size(); ++i)
+        values[i] = T(i * 0x9e3779b97f4a7c15);
+    std::vector<T> copy(values.size());
+
+    double per_value = seconds([&] {
+        for (std::size_t i = 0; i < values.size(); ++i)
+            ox::bswap(values.data() + i, sizeof(T), 1);
+    });
+    double in_place = seconds([&] { ox::bswap(values.data(), int(values.size())); });
+    double copied = seconds([&] { ox::bswap_copy(values.data(), copy.data(), values.size()); });
+    std::printf("%s: per value %6.2f GB/s, in place %6.2f GB/s, copy %6.2f GB/s (check %llu)\n", name,
+                double(bytes) / per_value / 1e9, double(bytes) / in_place / 1e9, double(bytes) / copied / 1e9,
+                (unsigned long long)(values[values.size() / 2] ^ copy[values.size() / 3]));
+}
+
+int main() {
+    run<ox::u16>("u16");
+    run<ox::u32>("u32");
+    run<ox::u64>("u64");
+}
@@ -0,0 +1,39 @@
+#ifndef OXLIB_TESTS_CHECK_H
+#define OXLIB_TESTS_CHECK_H
+
+#include <cstdio>
+
+/*
+ * The harness shared by the check programs under tests/: check prints every condition that does not hold, and
+ * main ends with return report(), which prints the tally and fails the program if any check did.
+ */
+
+inline int failures = 0;
+
+inline void check(bool ok, const char* what) {
+    if (!ok) {
+        ++failures;
+        printf("FAIL %s\n", what);
+    }
+}
+
+// Whether f throws an E
+template <typename E, typename F>
+bool throws(F&& f) {
+    try {
+        f();
+    } catch (const E&) {
+        return true;
+    }
+    return false;
+}
+
+inline int report() {
+    if (failures)
+        printf("%d failures\n", failures);
+    else
+        printf("all passed\n");
+    return failures != 0;
+}
+
+#endif // OXLIB_TESTS_CHECK_H
@@ -0,0 +1,128 @@
+#include <ox/math.h>
+#include <map>
+#include <sstream>
+#include <string>
+#include "check.h"
+
+/*
+ * Checks ox::system::expression_dag: hash-consing, the reduce and expand_multiplication rewrites and the round trip
+ * through math_tree_node, against hand computed results and by evaluating both sides of every rewrite.
+ * Links with src/expression_dag.cpp and src/system_solver.cpp.
+ */
+
+using namespace ox::system;
+
+std::string printed(const expression_dag& dag, expr_id id) {
+    std::ostringstream os;
+    dag.print(id, os);
+    return os.str();
+}
+
+long evaluate(const expression_dag& dag, expr_id id, const std::map<std::string, long>& values) {
+    const expr_node& n = dag[id];
+    switch (n.type) {
+        case expr_node::kind::constant:
+            return n.value;
+        case expr_node::kind::symbol:
+            return values.at(dag.get_symbols().name(symbol_id(n.value)));
+        default:
+            return op_fun[int8_t(n.oper)](evaluate(dag, n.left, values), evaluate(dag, n.right, values));
+    }
+}
+
+// Both expressions agree on a few assignments of their variables
+bool same_values(const expression_dag& dag, expr_id a, expr_id b) {
+    for (long seed = 1; seed < 6; ++seed) {
+        std::map<std::string, long> values;
+        for (std::size_t i = 0; i < dag.get_symbols().size(); ++i)
+            values[dag.get_symbols().name(symbol_id(i))] = seed * 7 + long(i) * 3 - 11;
+        if (evaluate(dag, a, values) != evaluate(dag, b, values))
+            return false;
+    }
+    return true;
+}
+
+void interning_test() {
+    expression_dag dag;
+    expr_id x = dag.symbol("x");
+    expr_id sum = dag.make(op::PLUS, x, dag.constant(1));
+    std::size_t size = dag.size();
+    check(dag.symbol("x") == x, "a symbol is interned once");
+    check(dag.make(op::PLUS, dag.symbol("x"), dag.constant(1)) == sum, "equal subexpressions share an id");
+    check(dag.size() == size, "rebuilding an expression adds no node");
+    check(dag.make(op::PLUS, dag.constant(1), x) != sum, "operand order matters");
+    check(dag.find_symbol("y") == -1, "unknown symbols are not found");
+
+    expr_id nested = dag.make(op::MUL, sum, dag.make(op::MIN, sum, dag.symbol("y")));
+    check(dag.from_tree(dag.to_tree(nested)) == nested, "math_tree round trip gives back the same id");
+    check(dag.contains(nested, dag.find_symbol("y")), "contains finds y");
+    check(!dag.contains(sum, dag.find_symbol("y")), "x + 1 does not contain y");
+}
+
+void reduce_test() {
+    expression_dag dag;
+    expr_id x = dag.symbol("x");
+    expr_id y = dag.symbol("y");
+
+    check(dag.reduce(dag.make(op::PLUS, dag.make(op::MUL, x, dag.constant(1)), dag.constant(0))) == x,
+          "(x * 1) + 0 is x");
+    check(dag.reduce(dag.make(op::MUL, dag.make(op::PLUS, dag.constant(2), dag.constant(3)), y))
+                  == dag.make(op::MUL, dag.constant(5), y),
+          "(2 + 3) * y is 5 * y");
+    check(dag.reduce(dag.make(op::MUL, x, dag.constant(0))) == dag.constant(0), "x * 0 is 0");
+    check(dag.reduce(dag.make(op::DIV, x, dag.constant(1))) == x, "x / 1 is x");
+    check(dag.reduce(dag.make(op::MIN, x, dag.constant(-3))) == dag.make(op::PLUS, x, dag.constant(3)),
+          "x - -3 is x + 3");
+    check(dag.reduce(dag.make(op::PLUS, x, dag.constant(-3))) == dag.make(op::MIN, x, dag.constant(3)),
+          "x + -3 is x - 3");
+    check(dag.reduce(dag.make(op::DIV, dag.constant(12), dag.constant(4))) == dag.constant(3), "12 / 4 is 3");
+    expr_id by_zero = dag.make(op::DIV, dag.constant(1), dag.constant(0));
+    check(dag.reduce(by_zero) == by_zero, "1 / 0 is left alone");
+
+    expr_id e = dag.make(op::MIN,
+                         dag.make(op::MUL, dag.make(op::MIN, dag.constant(7), dag.constant(7)), x),
+                         dag.make(op::PLUS, y, dag.make(op::MUL, dag.constant(2), dag.constant(-4))));
+    expr_id reduced = dag.reduce(e);
+    check(printed(dag, reduced) == "(0-(y-8))", "0 * x - (y + 2 * -4) is 0 - (y - 8)");
+    check(same_values(dag, e, reduced), "reduce keeps the value");
+    check(dag.reduce(reduced) == reduced, "reduce is idempotent");
+}
+
+void expand_test() {
+    expression_dag dag;
+    expr_id a = dag.symbol("a"), b = dag.symbol("b"), c = dag.symbol("c"), d = dag.symbol("d");
+
+    expr_id product = dag.make(op::MUL, dag.make(op::PLUS, a, b), dag.make(op::MIN, c, d));
+    expr_id expanded = dag.expand_multiplication(product);
+    check(printed(dag, expanded) == "(((c*a)+(c*b))-((d*a)+(d*b)))", "(a + b) * (c - d) distributes");
+    check(same_values(dag, product, expanded), "expand keeps the value");
+
+    auto terms = dag.terms(expanded);
+    check(terms.size() == 4, "(a + b) * (c - d) has four terms");
+    int negative = 0;
+    for (auto [term, sign] : terms) {
+        check(dag.is_operation(term, op::MUL), "every term is a product");
+        negative += sign == op::MIN;
+    }
+    check(negative == 2, "two of the terms are subtracted");
+
+    // the multiplier is shared by both products, not copied
+    expr_id shared = dag.make(op::MUL, dag.make(op::MUL, a, b), dag.make(op::PLUS, c, d));
+    expr_id distributed = dag.expand_multiplication(shared);
+    check(dag[dag[distributed].left].left == dag[dag[distributed].right].left, "a * b is shared by both products");
+
+    expr_id deep = dag.make(op::MUL,
+                            dag.make(op::MIN, dag.make(op::PLUS, a, dag.constant(2)), b),
+                            dag.make(op::MUL, dag.make(op::PLUS, c, d), dag.make(op::MIN, a, dag.constant(5))));
+    expr_id deep_expanded = dag.expand_multiplication(deep);
+    check(same_values(dag, deep, deep_expanded), "nested products expand to the same value");
+    check(dag.terms(deep_expanded).size() == 12, "(a + 2 - b) * (c + d) * (a - 5) has twelve terms");
+    check(dag.expand_multiplication(deep_expanded) == deep_expanded, "expand is idempotent");
+}
+
+int main() {
+    interning_test();
+    reduce_test();
+    expand_test();
+    return report();
+}
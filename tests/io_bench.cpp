@@ -0,0 +1,109 @@
+#include <ox/io.h>
+#include <ox/ranges.h>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+/*
+ * Iterates the lines of an in-memory buffer of short and long lines, one in five ending in \r\n, summing their lengths
+ * without the \r, through getline on an istringstream, ox::delimited_view and ox::ranges::views::split_lines, and
+ * reports the throughput of each.
+ * The same input is then written to a file and read back with getline on an ifstream, ox::file::read_line into a
+ * reused string, ox::file::read_all followed by split_lines, and ox::chunk_reader, whose background thread reads the
+ * next chunks while the lines of the current one are counted.
+ */
+
+constexpr std::size_t lines = 4000000;
+
+template <typename F>
+double seconds(F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+std::string make_input() {
+    std::string input;
+    for (std::size_t i = 0; i < lines; ++i) {
+        input.append(std::size_t(i * 7919 % 97), 'x');
+        input += i % 5 ? "\n" : "\r\n";
+    }
+    return input;
+}
+
+// split_lines drops the \r of a \r\n line end, so the other loops drop it too to do the same work
+std::size_t content_length(std::string_view line) {
+    return line.size() - (!line.empty() && line.back() == '\r');
+}
+
+void report(const char* name, std::size_t bytes, double s, std::size_t total) {
+    std::printf("%-12s %7.2f GB/s (total %zu)\n", name, double(bytes) / s / 1e9, total);
+}
+
+int main() {
+    std::string input = make_input();
+    std::size_t total = 0;
+
+    double getline_s = seconds([&] {
+        std::istringstream in(input);
+        for (std::string line; std::getline(in, line);)
+            total += content_length(line);
+    });
+    report("getline", input.size(), getline_s, total);
+
+    total = 0;
+    double delimited_s = seconds([&] {
+        for (std::string_view line : ox::delimited_view(input, '\n', ox::trailing_piece::dropped))
+            total += content_length(line);
+    });
+    report("delimited", input.size(), delimited_s, total);
+
+    total = 0;
+    double split_lines_s = seconds([&] {
+        for (std::string_view line : input | oxv::split_lines)
+            total += line.size();
+    });
+    report("split_lines", input.size(), split_lines_s, total);
+
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "ox_io_bench.txt";
+    std::ofstream(path, std::ios::binary) << input;
+
+    total = 0;
+    double ifstream_s = seconds([&] {
+        std::ifstream in(path, std::ios::binary);
+        for (std::string line; std::getline(in, line);)
+            total += content_length(line);
+    });
+    report("ifstream", input.size(), ifstream_s, total);
+
+    total = 0;
+    double read_line_s = seconds([&] {
+        ox::file f(path, "rb");
+        for (std::string line; f.read_line(line);)
+            total += content_length(line);
+    });
+    report("read_line", input.size(), read_line_s, total);
+
+    total = 0;
+    double read_all_s = seconds([&] {
+        ox::file f(path, "rb");
+        std::string all = f.read_all();
+        for (std::string_view line : all | oxv::split_lines)
+            total += line.size();
+    });
+    report("read_all", input.size(), read_all_s, total);
+
+    total = 0;
+    double chunk_reader_s = seconds([&] {
+        ox::file f(path, "rb");
+        ox::chunk_reader reader(f);
+        for (std::string_view line : reader.lines())
+            total += line.size();
+    });
+    report("chunk_reader", input.size(), chunk_reader_s, total);
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,140 @@
+#include <ox/math.h>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+#include "check.h"
+
+/*
+ * Checks ox::system::linear_system against systems with known solutions, over ox::rational and over a prime
+ * ox::modulo, the ox::modulo division and berlekamp_massey over it, and the ox::rational sum and sign normalisation
+ * the elimination relies on.
+ * Links with src/expression_dag.cpp and src/system_solver.cpp.
+ */
+
+using namespace ox::system;
+
+math_tree_node leaf(long value) { return math_tree_node(value); }
+math_tree_node leaf(const char* name) { return math_tree_node(std::string(name)); }
+
+math_tree_node node(op oper, math_tree_node left, math_tree_node right) {
+    math_tree_node to_return(oper);
+    to_return.emplace_left(std::move(left));
+    to_return.emplace_right(std::move(right));
+    return to_return;
+}
+
+// coefficient * name
+math_tree_node term(long coefficient, const char* name) { return node(op::MUL, leaf(coefficient), leaf(name)); }
+
+void rational_test() {
+    using ox::rational;
+    check(rational(1, 6) + rational(1, 4) == rational(5, 12), "1/6 + 1/4 is 5/12");
+    check(rational(1, 6) - rational(1, 4) == rational(-1, 12), "1/6 - 1/4 is -1/12");
+    check(rational(3, 10) + rational(7, 15) == rational(23, 30), "3/10 + 7/15 is 23/30");
+    check(rational(2, 3) * rational(9, 4) == rational(3, 2), "2/3 * 9/4 is 3/2");
+
+    rational negative(3, -6);
+    check(negative.numerator == -1 && negative.denominator == 2, "3/-6 is -1/2, sign on the numerator");
+    check(rational(-4, -8).numerator == 1 && rational(-4, -8).denominator == 2, "-4/-8 is 1/2");
+    check(negative + rational(1, 2) == rational(0), "-1/2 + 1/2 is 0");
+    check((negative + rational(1, 3)).is_normalized(), "sums come out normalised");
+    check(rational(1, 3) / rational(-2, 3) == rational(-1, 2), "1/3 / -2/3 is -1/2");
+    check(rational(-1, 2) < rational(1, -3), "-1/2 < -1/3");
+
+    // the cross sum 2^63 + 4 overflows before the reduction by 2 brings it back in range
+    rational sum;
+    check(!throws<ox::rational_overflow_error>([&] { sum = rational((1L << 62) + 1, 6) + rational((1L << 62) + 3, 6); })
+                  && sum == rational((1L << 62) + 2, 3),
+          "(2^62 + 1)/6 + (2^62 + 3)/6 is (2^62 + 2)/3");
+}
+
+void unique_test() {
+    // 2x + 3y = 8, x - y = -1
+    linear_system<> system;
+    system.add_equation(node(op::PLUS, term(2, "x"), term(3, "y")), leaf(8));
+    system.add_equation(node(op::MIN, leaf("x"), leaf("y")), leaf(-1));
+    auto solution = system.solve();
+    check(solution.kind == solution_kind::unique, "2x + 3y = 8, x - y = -1 has one solution");
+    check(solution.value_of("x") == ox::rational(1) && solution.value_of("y") == ox::rational(2), "x = 1, y = 2");
+
+    // x + y + z = 6, 2y + 5z = -4, 2x + 5y - z = 27
+    linear_system<> three;
+    three.add_equation(node(op::PLUS, node(op::PLUS, leaf("x"), leaf("y")), leaf("z")), leaf(6));
+    three.add_equation(node(op::PLUS, term(2, "y"), term(5, "z")), leaf(-4));
+    three.add_equation(node(op::MIN, node(op::PLUS, term(2, "x"), term(5, "y")), leaf("z")), leaf(27));
+    auto s3 = three.solve();
+    check(s3.kind == solution_kind::unique, "the 3 x 3 system has one solution");
+    check(s3.value_of("x") == ox::rational(5) && s3.value_of("y") == ox::rational(3)
+                  && s3.value_of("z") == ox::rational(-2),
+          "x = 5, y = 3, z = -2");
+
+    // fractional solution: x + y = 1, x - y = 1 / 2, 3z = x
+    linear_system<> fractions;
+    fractions.add_equation(node(op::PLUS, leaf("x"), leaf("y")), leaf(1));
+    fractions.add_equation(node(op::MIN, leaf("x"), leaf("y")), node(op::DIV, leaf(1), leaf(2)));
+    fractions.add_equation(term(3, "z"), leaf("x"));
+    auto sf = fractions.solve();
+    check(sf.kind == solution_kind::unique, "the fractional system has one solution");
+    check(sf.value_of("x") == ox::rational(3, 4) && sf.value_of("y") == ox::rational(1, 4)
+                  && sf.value_of("z") == ox::rational(1, 4),
+          "x = 3/4, y = 1/4, z = 1/4");
+
+    // variables on both sides and repeated: 2(x + 1) = x + x / 2 + 5
+    linear_system<> sides;
+    sides.add_equation(node(op::MUL, leaf(2), node(op::PLUS, leaf("x"), leaf(1))),
+                       node(op::PLUS, node(op::PLUS, leaf("x"), node(op::DIV, leaf("x"), leaf(2))), leaf(5)));
+    check(sides.solve().value_of("x") == ox::rational(6), "2(x + 1) = x + x/2 + 5 gives x = 6");
+}
+
+void degenerate_test() {
+    linear_system<> under;
+    under.add_equation(node(op::PLUS, leaf("x"), leaf("y")), leaf(2));
+    auto su = under.solve();
+    check(su.kind == solution_kind::underdetermined, "x + y = 2 is underdetermined");
+    check(su.free[0] != su.free[1], "exactly one of x and y is free");
+    check(*su.value_of("x") + *su.value_of("y") == ox::rational(2), "the particular solution satisfies x + y = 2");
+
+    linear_system<> inconsistent;
+    inconsistent.add_equation(node(op::PLUS, leaf("x"), leaf("y")), leaf(1));
+    inconsistent.add_equation(node(op::PLUS, term(2, "x"), term(2, "y")), leaf(3));
+    auto si = inconsistent.solve();
+    check(si.kind == solution_kind::inconsistent, "x + y = 1, 2x + 2y = 3 is inconsistent");
+    check(!si.value_of("x"), "an inconsistent system has no values");
+
+    linear_system<> nonlinear;
+    check(throws<nonlinear_equation_error>(
+                  [&] { nonlinear.add_equation(node(op::MUL, leaf("x"), leaf("y")), leaf(1)); }),
+          "x * y = 1 is rejected as nonlinear");
+}
+
+void modulo_test() {
+    using field = ox::modulo<1000000007>;
+    // 3x + y = 1, x - y = 2 has x = 3/4, y = -5/4
+    linear_system<field> system;
+    system.add_equation(node(op::PLUS, term(3, "x"), leaf("y")), leaf(1));
+    system.add_equation(node(op::MIN, leaf("x"), leaf("y")), leaf(2));
+    auto solution = system.solve();
+    check(solution.kind == solution_kind::unique, "the modular system has one solution");
+    check(*solution.value_of("x") * 4 == 3 && *solution.value_of("y") * 4 == -5, "x = 3/4, y = -5/4 mod p");
+
+    field seven = 7;
+    check(seven / 2 == 3, "/ divides the residue as an integer");
+    check(seven.divide(2) * 2 == 7 && ox::reciprocal(seven) * 7 == 1, "divide and reciprocal are modular");
+    check(throws<ox::div_by_zero_error>([&] { (void) seven.divide(0); }), "dividing by 0 throws");
+
+    // s[n] = 2 s[n - 1] + 3 s[n - 2], whose discrepancies do not divide as integers
+    std::vector<field> s{1, 5};
+    for (int i = 0; i < 8; ++i)
+        s.push_back(s[s.size() - 1] * 2 + s[s.size() - 2] * 3);
+    check(ox::berlekamp_massey(std::span<const field>(s)) == std::vector<field>{2, 3},
+          "berlekamp_massey finds the recurrence mod p");
+}
+
+int main() {
+    rational_test();
+    unique_test();
+    degenerate_test();
+    modulo_test();
+    return report();
+}
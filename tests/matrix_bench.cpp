@@ -0,0 +1,78 @@
+#include <ox/matrix.h>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+/*
+ * Compares the expression template evaluation of a four-term elementwise update, x = a + b - c * 2 + d * 0.5 over
+ * 1000 x 1000 doubles, against the eager evaluation ox::matrix used to do, where every operator copied its left
+ * operand and applied the compound assignment to the copy, allocating one temporary per operation.
+ */
+
+using matrix = ox::matrix<double>;
+
+constexpr std::size_t size = 1000;
+constexpr int iterations = 20;
+
+template <typename F>
+long time_ms(F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+}
+
+matrix eager_sum(const matrix& a, const matrix& b) {
+    matrix to_return = a;
+    to_return += b;
+    return to_return;
+}
+
+matrix eager_difference(const matrix& a, const matrix& b) {
+    matrix to_return = a;
+    to_return -= b;
+    return to_return;
+}
+
+matrix eager_scaled(const matrix& a, double s) {
+    matrix to_return = a;
+    to_return *= s;
+    return to_return;
+}
+
+matrix random_matrix(std::mt19937_64& rng) {
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    std::vector<double> values(size * size);
+    for (double& v : values)
+        v = dist(rng);
+    return matrix(long(size), std::move(values));
+}
+
+double checksum(const matrix& m) {
+    double sum = 0;
+    for (std::size_t i = 0; i < size * size; ++i)
+        sum += m.element(i);
+    return sum;
+}
+
+int main() {
+    std::mt19937_64 rng(42);
+    matrix a = random_matrix(rng), b = random_matrix(rng), c = random_matrix(rng), d = random_matrix(rng);
+
+    matrix x;
+    long eager = time_ms([&] {
+        for (int i = 0; i < iterations; ++i)
+            x = eager_sum(eager_difference(eager_sum(a, b), eager_scaled(c, 2)), eager_scaled(d, 0.5));
+    });
+    double eager_checksum = checksum(x);
+
+    matrix y = a;
+    long expression = time_ms([&] {
+        for (int i = 0; i < iterations; ++i)
+            y = a + b - c * 2 + d * 0.5;
+    });
+
+    std::printf("eager       %4ld ms  (%.6f)\n", eager, eager_checksum);
+    std::printf("expression  %4ld ms  (%.6f)\n", expression, checksum(y));
+}
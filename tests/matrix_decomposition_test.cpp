@@ -0,0 +1,175 @@
+#include <ox/math.h>
+#include <ox/matrix.h>
+#include <cmath>
+#include <initializer_list>
+#include <random>
+#include <vector>
+#include "check.h"
+
+/*
+ * Checks the LU, QR and Cholesky decompositions, Bareiss determinants and inverses against hand computed results,
+ * and larger random matrices against the identities they must satisfy (P A = L U, Q^T Q = I, Q R = A, A A^-1 = I).
+ */
+
+template <typename T>
+bool equal(const ox::matrix<T>& m, std::size_t width, std::initializer_list<T> expected, double tolerance = 1e-9) {
+    if (m.get_width() != width || m.get_width() * m.get_height() != expected.size())
+        return false;
+    std::size_t i = 0;
+    for (const T& value : expected) {
+        if constexpr (std::is_floating_point_v<T>) {
+            if (std::abs(m.element(i) - value) > tolerance)
+                return false;
+        } else if (!(m.element(i) == value)) {
+            return false;
+        }
+        ++i;
+    }
+    return true;
+}
+
+bool near(const ox::matrix<double>& a, const ox::matrix<double>& b, double tolerance) {
+    if (a.get_width() != b.get_width() || a.get_height() != b.get_height())
+        return false;
+    for (std::size_t i = 0; i < std::size_t(a.get_width() * a.get_height()); ++i)
+        if (std::abs(a.element(i) - b.element(i)) > tolerance)
+            return false;
+    return true;
+}
+
+ox::matrix<double> random_matrix(std::size_t width, std::size_t height, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    std::vector<double> values(width * height);
+    for (double& v : values)
+        v = dist(gen);
+    return ox::matrix<double>(long(width), std::move(values));
+}
+
+// L and U multiplied back together
+template <typename T>
+ox::matrix<T> recomposed(const ox::lu_decomposition<T>& d) {
+    std::size_t n = d.lu.get_width();
+    std::vector<T> l(n * n, T(0)), u(n * n, T(0));
+    for (std::size_t i = 0; i < n; ++i)
+        for (std::size_t j = 0; j < n; ++j) {
+            T value = d.lu.element(i * n + j);
+            if (j < i)
+                l[i * n + j] = value;
+            else
+                u[i * n + j] = value;
+            if (i == j)
+                l[i * n + j] = T(1);
+        }
+    return ox::matrix<T>(ox::matrix<T>(long(n), std::move(l)) * ox::matrix<T>(long(n), std::move(u)));
+}
+
+void lu_test() {
+    ox::matrix<double> a(3, {2.0, 1.0, 1.0, 4.0, -6.0, 0.0, -2.0, 7.0, 2.0});
+    auto d = ox::lu(a);
+    check(std::abs(d.determinant() - -16.0) < 1e-9, "det [[2 1 1] [4 -6 0] [-2 7 2]] is -16");
+    check(equal(d.solve(ox::matrix<double>(1, {5.0, -2.0, 9.0})), 1, {1.0, 1.0, 2.0}), "A x = (5 -2 9) gives (1 1 2)");
+    check(near(ox::matrix<double>(a * d.inverse()), ox::matrix<double>::identity(3), 1e-12), "A A^-1 is I");
+
+    // larger than one 64 column panel, so the blocked trailing update runs
+    ox::matrix<double> big = random_matrix(150, 150, 1);
+    auto db = ox::lu(big);
+    ox::matrix<double> lu = recomposed(db);
+    bool permuted = true;
+    for (std::size_t i = 0; i < 150; ++i)
+        for (std::size_t j = 0; j < 150; ++j)
+            permuted = permuted && std::abs(lu.element(i * 150 + j) - big.element(db.permutation[i] * 150 + j)) < 1e-9;
+    check(permuted, "P A = L U for a random 150 x 150 matrix");
+    check(near(ox::matrix<double>(big * db.inverse()), ox::matrix<double>::identity(150), 1e-8),
+          "A A^-1 is I for a random 150 x 150 matrix");
+
+    // exact fields: the first non-zero pivot, here below a zero diagonal
+    using ox::rational;
+    ox::matrix<rational> r(3, {rational(0), rational(2), rational(1),
+                               rational(1), rational(1), rational(0),
+                               rational(3), rational(0), rational(1)});
+    auto dr = ox::lu(r);
+    check(dr.determinant() == rational(-5), "det [[0 2 1] [1 1 0] [3 0 1]] is -5");
+    check(equal(dr.inverse(), 3, {rational(-1, 5), rational(2, 5), rational(1, 5),
+                                  rational(1, 5), rational(3, 5), rational(-1, 5),
+                                  rational(3, 5), rational(-6, 5), rational(2, 5)}),
+          "the rational inverse is exact");
+    check(equal(ox::inverse(ox::matrix<rational>(2, {rational(4), rational(7), rational(2), rational(6)})), 2,
+                {rational(3, 5), rational(-7, 10), rational(-1, 5), rational(2, 5)}),
+          "[[4 7] [2 6]]^-1 is [[3/5 -7/10] [-1/5 2/5]]");
+
+    using mod = ox::modulo<1000000007>;
+    ox::matrix<mod> m(2, {mod(0), mod(3), mod(5), mod(7)});
+    auto dm = ox::lu(m);
+    check(dm.determinant() == -15, "det [[0 3] [5 7]] is -15 mod p");
+    check(equal(ox::matrix<mod>(m * dm.inverse()), 2, {mod(1), mod(0), mod(0), mod(1)}), "A A^-1 is I mod p");
+
+    auto singular = ox::lu(ox::matrix<double>(2, {1.0, 2.0, 2.0, 4.0}));
+    check(singular.singular
+                  && throws<ox::singular_matrix_error>(
+                          [&] { (void) singular.solve(ox::matrix<double>(1, {1.0, 1.0})); }),
+          "a singular matrix is reported and refuses to solve");
+}
+
+void determinant_test() {
+    check(ox::bareiss_determinant(ox::matrix<long>(3, {2, -3, 1, 2, 0, -1, 1, 4, 5})) == 49,
+          "det [[2 -3 1] [2 0 -1] [1 4 5]] is 49");
+    check(ox::determinant(ox::matrix<long>(2, {0, 1, 1, 0})) == -1, "a row swap flips the sign");
+    check(ox::determinant(ox::matrix<long>(3, {1, 2, 3, 4, 5, 6, 7, 8, 9})) == 0,
+          "[[1 2 3] [4 5 6] [7 8 9]] is singular");
+    // Vandermonde on 1..5: the product of (j - i) over i < j
+    std::vector<long> vandermonde;
+    for (long x = 1; x <= 5; ++x)
+        for (long p = 0, power = 1; p < 5; ++p, power *= x)
+            vandermonde.push_back(power);
+    check(ox::determinant(ox::matrix<long>(5, std::move(vandermonde))) == 288,
+          "the 5 x 5 Vandermonde determinant is 288");
+    check(ox::determinant(ox::matrix<ox::rational>(2, {ox::rational(1, 2), ox::rational(1, 3),
+                                                       ox::rational(1, 4), ox::rational(1, 5)}))
+                  == ox::rational(1, 60),
+          "det [[1/2 1/3] [1/4 1/5]] is 1/60");
+    check(std::abs(ox::determinant(ox::matrix<double>(2, {3.0, 8.0, 4.0, 6.0})) - -14.0) < 1e-12,
+          "det [[3 8] [4 6]] is -14");
+}
+
+void qr_test() {
+    ox::matrix<double> a = random_matrix(5, 8, 2);
+    auto d = ox::qr(a);
+    ox::matrix<double> q = d.q(), r = d.r();
+    check(near(ox::matrix<double>(q.transpose() * q), ox::matrix<double>::identity(5), 1e-12), "Q^T Q is I");
+    check(near(ox::matrix<double>(q * r), a, 1e-12), "Q R is A");
+    bool upper = true;
+    for (std::size_t i = 0; i < 5; ++i)
+        for (std::size_t j = 0; j < i; ++j)
+            upper = upper && r.element(i * 5 + j) == 0.0;
+    check(upper, "R is upper triangular");
+
+    // y = 1 + 2 x through four exact points
+    ox::matrix<double> points(2, {1.0, 0.0, 1.0, 1.0, 1.0, 2.0, 1.0, 3.0});
+    check(equal(ox::least_squares(points, ox::matrix<double>(1, {1.0, 3.0, 5.0, 7.0})), 1, {1.0, 2.0}),
+          "the line through (0 1) (1 3) (2 5) (3 7) is 1 + 2x");
+    // a constant fitted to 1, 2, 6 is their mean
+    check(equal(ox::least_squares(ox::matrix<double>(1, {1.0, 1.0, 1.0}), ox::matrix<double>(1, {1.0, 2.0, 6.0})), 1,
+                {3.0}),
+          "the least squares constant is the mean");
+}
+
+void cholesky_test() {
+    ox::matrix<double> a(3, {4.0, 12.0, -16.0, 12.0, 37.0, -43.0, -16.0, -43.0, 98.0});
+    auto d = ox::cholesky(a);
+    check(equal(d.l, 3, {2.0, 0.0, 0.0, 6.0, 1.0, 0.0, -8.0, 5.0, 3.0}), "L is [[2 0 0] [6 1 0] [-8 5 3]]");
+    check(equal(d.solve(ox::matrix<double>(1, {-8.0, -25.0, 27.0})), 1, {1.0, -1.0, 0.0}),
+          "A x = (-8 -25 27) gives (1 -1 0)");
+
+    check(throws<ox::not_positive_definite_error>(
+                  [] { (void) ox::cholesky(ox::matrix<double>(2, {1.0, 2.0, 2.0, 1.0})); }),
+          "an indefinite matrix is rejected");
+}
+
+int main() {
+    lu_test();
+    determinant_test();
+    qr_test();
+    cholesky_test();
+    return report();
+}
@@ -0,0 +1,88 @@
+#include <ox/matrix.h>
+#include <cstdio>
+#include <initializer_list>
+#include "check.h"
+
+/*
+ * Checks ox::matrix arithmetic against hand computed results, in particular assignments whose destination is also
+ * an operand, with and without a change of shape.
+ */
+
+void check(const ox::matrix<int>& m, std::size_t width, std::size_t height, std::initializer_list<int> expected,
+           const char* what) {
+    bool ok = m.get_width() == width && m.get_height() == height;
+    std::size_t i = 0;
+    for (int value : expected)
+        ok = ok && m.element(i++) == value;
+    check(ok, what);
+    if (!ok) {
+        printf("    got %zu x %zu", std::size_t(m.get_width()), std::size_t(m.get_height()));
+        for (std::size_t j = 0; j < std::size_t(m.get_width() * m.get_height()); ++j)
+            printf(" %d", m.element(j));
+        printf("\n");
+    }
+}
+
+void product_test() {
+    ox::matrix<int> a(2, {1, 2, 3, 4});
+    ox::matrix<int> b(3, {1, 0, 0, 0, 1, 0});
+    ox::matrix<int> c = a * b;
+    check(c, 3, 2, {1, 2, 0, 3, 4, 0}, "A * B");
+
+    ox::matrix<int> d = a;
+    d = d * b;
+    check(d, 3, 2, {1, 2, 0, 3, 4, 0}, "A = A * B, B 2 x 3");
+
+    d = a;
+    d *= b;
+    check(d, 3, 2, {1, 2, 0, 3, 4, 0}, "A *= B, B 2 x 3");
+
+    d = a;
+    d *= d;
+    check(d, 2, 2, {7, 10, 15, 22}, "A *= A");
+
+    ox::matrix<int> e(2, {0, 1, 1, 0});
+    e = a * e;
+    check(e, 2, 2, {2, 1, 4, 3}, "B = A * B");
+
+    ox::matrix<int> f(1, {5, 6});
+    ox::matrix<int> g = a;
+    g = g * f;
+    check(g, 1, 2, {17, 39}, "A = A * v");
+}
+
+void elementwise_test() {
+    ox::matrix<int> a(2, {1, 2, 3, 4});
+    ox::matrix<int> b(2, {10, 20, 30, 40});
+    ox::matrix<int> c = a + b * 2 - a;
+    check(c, 2, 2, {20, 40, 60, 80}, "A + 2B - A");
+
+    c = a;
+    c = c + c;
+    check(c, 2, 2, {2, 4, 6, 8}, "C = C + C");
+
+    c = a;
+    c += a * b;
+    check(c, 2, 2, {71, 102, 153, 224}, "C += A * B");
+
+    ox::matrix<int> t = a;
+    t = t.transposed_view() + a;
+    check(t, 2, 2, {2, 5, 5, 8}, "T = T^t + A");
+
+    ox::matrix<int> r(3, {1, 2, 3, 4, 5, 6});
+    r = r.transposed_view() * 1;
+    check(r, 2, 3, {1, 4, 2, 5, 3, 6}, "R = R^t, resized");
+}
+
+void pow_test() {
+    ox::matrix<int> fibonacci(2, {1, 1, 1, 0});
+    check(fibonacci.pow(10), 2, 2, {89, 55, 55, 34}, "fibonacci^10");
+    check(fibonacci.pow(0), 2, 2, {1, 0, 0, 1}, "fibonacci^0");
+}
+
+int main() {
+    product_test();
+    elementwise_test();
+    pow_test();
+    return report();
+}
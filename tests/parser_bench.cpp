@@ -0,0 +1,107 @@
+#include <ox/parser.h>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+/*
+ * Parses the same line-oriented input ("Game 17: 3 blue, 4 red; 1 red, 2 green; ...") with the dynamic
+ * ox::parser grammar and with its ox::parser::typed equivalent, summing every count through callbacks.
+ * Build once as is and once with -DOXLIB_PARSER_TRACE: with tracing compiled out the dynamic parser's timing does
+ * not depend on the debug switch, as no trace statement is left in its parse methods.
+ * The typed grammar is also run through parse_records, one chunk of lines per task on a thread_pool.
+ */
+
+constexpr int lines = 200000;
+constexpr int repetitions = 5;
+
+template <typename F>
+long time_ms(F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+}
+
+std::string make_input() {
+    const char* colors[] = {"red", "green", "blue"};
+    std::string input;
+    for (int i = 0; i < lines; ++i) {
+        input += "Game " + std::to_string(i) + ":";
+        for (int pull = 0; pull < 3; ++pull) {
+            for (int c = 0; c < 3; ++c)
+                input += " " + std::to_string((i + pull + c) % 17) + " " + colors[(i + c) % 3] + (c < 2 ? "," : "");
+            input += pull < 2 ? ";" : "";
+        }
+        input += i + 1 < lines ? "\n" : "";
+    }
+    return input;
+}
+
+long dynamic_parse(std::string_view input) {
+    using namespace ox::parser;
+    using namespace ox::parser::literals;
+    long total = 0;
+    auto count = [](void* ref, long n) {
+        *static_cast<long*>(ref) += n;
+        return n;
+    };
+    List grammar("\n",
+                 "Game"_l + Int() + ":"_l
+                         + List(";", List(",", Int(count) + ("red"_l | "green"_l | "blue"_l))));
+    if (!grammar.parse(&total, input))
+        std::puts("dynamic parse failed");
+    return total;
+}
+
+long typed_parse(std::string_view input) {
+    using namespace ox::parser::typed;
+    using namespace ox::parser::typed::literals;
+    long total = 0;
+    auto pull = map(Int() + ("red"_l | "green"_l | "blue"_l), [&](long n, std::string_view) { total += n; });
+    auto grammar = List("\n", "Game"_l + Int() + ":"_l + List(";", List(",", pull)));
+    if (!parse(grammar, input))
+        std::puts("typed parse failed");
+    return total;
+}
+
+// The same records split across a thread_pool; callbacks would run concurrently, so this sums the game ids instead
+long parallel_parse(std::string_view input, ox::thread_pool<std::function<void()>>& pool) {
+    using namespace ox::parser::typed;
+    using namespace ox::parser::typed::literals;
+    auto record = "Game"_l + Int() + ":"_l + List(";", List(",", Int() + ("red"_l | "green"_l | "blue"_l)));
+    auto games = parse_records(record, input, pool);
+    if (!games) {
+        std::puts("parallel parse failed");
+        return 0;
+    }
+    long total = 0;
+    for (const auto& game : *games)
+        total += std::get<1>(game);
+    return total;
+}
+
+int main() {
+    std::string input = make_input();
+    std::printf("tracing compiled %s, %zu bytes\n", ox::parser::tracing ? "in" : "out", input.size());
+
+    long dynamic_total = 0, typed_total = 0;
+    long dynamic_ms = time_ms([&] {
+        for (int r = 0; r < repetitions; ++r)
+            dynamic_total += dynamic_parse(input);
+    });
+    long typed_ms = time_ms([&] {
+        for (int r = 0; r < repetitions; ++r)
+            typed_total += typed_parse(input);
+    });
+    ox::thread_pool<std::function<void()>> pool;
+    long parallel_total = 0;
+    long parallel_ms = time_ms([&] {
+        for (int r = 0; r < repetitions; ++r)
+            parallel_total += parallel_parse(input, pool);
+    });
+    std::printf("dynamic: %5ld ms (sum %ld)\n", dynamic_ms, dynamic_total);
+    std::printf("typed:   %5ld ms (sum %ld)\n", typed_ms, typed_total);
+    std::printf("parallel typed: %5ld ms (sum of ids %ld)\n", parallel_ms, parallel_total);
+}
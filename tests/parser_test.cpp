@@ -0,0 +1,245 @@
+#include <ox/parser.h>
+#include <ox/threading.h>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <variant>
+#include <vector>
+#include "check.h"
+
+/*
+ * Checks the ox::parser::typed combinators: the values and lengths they produce, Or's value type and dispatch,
+ * map spreading Combination tuples, List against the dynamic List for every ListEnding, Memoized replay, the
+ * furthest failure reported through a failure_tracker, and parse_records against a sequential List. Also checks
+ * the dynamic Or's dispatch past its indexed alternatives.
+ */
+
+namespace typed = ox::parser::typed;
+using namespace typed::literals;
+using ox::parser::ListEnding;
+
+template <typename T>
+bool parses(const typed::result<T>& read, std::size_t length, const T& value) {
+    return read && read->length == length && read->value == value;
+}
+
+void value_test() {
+    check(parses(typed::parse("Game"_l, "  Game 1"), 6, std::string_view("Game")), "a literal after whitespace");
+    check(!typed::parse("Game"_l, "Gam"), "a truncated literal fails");
+    check(parses(typed::parse(typed::Int(), " -42x"), 4, -42L), "a negative Int stops at the first non digit");
+    check(!typed::parse(typed::Int<unsigned>(), "-1"), "an unsigned Int rejects a sign");
+    check(!typed::parse(typed::Int<std::int8_t>(), "128"), "an Int that does not fit fails");
+    check(parses(typed::parse(typed::String(","), " red, blue"), 4, std::string_view("red")),
+          "a String stops at its delimiter");
+    check(parses(typed::parse(typed::String(), "\tred blue"), 4, std::string_view("red")),
+          "a String stops at whitespace");
+    check(parses(typed::parse(!"x"_l, "y"), 0, std::optional<std::string_view>()),
+          "a failing Optional matches nothing");
+    check(parses(typed::parse(!"x"_l, " x"), 2, std::optional<std::string_view>("x")),
+          "a matching Optional keeps the value");
+
+    auto game = "Game"_l + typed::Int() + ":"_l;
+    static_assert(std::is_same_v<decltype(game)::value_type, std::tuple<std::string_view, long, std::string_view>>);
+    check(parses(typed::parse(game, "Game 17: 3 red"), 8,
+                 std::tuple{std::string_view("Game"), 17L, std::string_view(":")}),
+          "a Combination collects every value in order");
+    check(!typed::parse(game, "Game x:"), "a Combination fails with any of its parts");
+}
+
+void or_test() {
+    auto color = "red"_l | "green"_l | "blue"_l;
+    static_assert(std::is_same_v<decltype(color)::value_type, std::string_view>);
+    check(parses(typed::parse(color, " blue"), 5, std::string_view("blue")), "alternatives of one type keep it");
+    check(!typed::parse(color, "purple"), "no alternative matches");
+
+    auto mixed = typed::Int() | "none"_l;
+    static_assert(std::is_same_v<decltype(mixed)::value_type, std::variant<long, std::string_view>>);
+    auto number = typed::parse(mixed, "12");
+    check(number && number->value.index() == 0 && std::get<0>(number->value) == 12, "an Int alternative is index 0");
+    auto none = typed::parse(mixed, " none");
+    check(none && none->value.index() == 1 && none->length == 5, "a literal alternative is index 1");
+
+    // ordered choice: the first alternative that matches wins even when a later one is longer
+    auto prefix = "ab"_l | "abc"_l;
+    check(parses(typed::parse(prefix, "abc"), 2, std::string_view("ab")), "the first matching alternative wins");
+    // alternatives that can start with whitespace or match nothing are never skipped by the dispatch table
+    auto spaced = " x"_l | typed::String();
+    check(parses(typed::parse(spaced, "  x"), 3, std::string_view(" x")), "a literal starting with whitespace");
+    check(parses(typed::parse(spaced, ""), 0, std::string_view()), "an alternative matching the empty input");
+}
+
+void map_test() {
+    auto pull = typed::map(typed::Int() + typed::String(","),
+                           [](long n, std::string_view color) { return std::string(color) + "=" + std::to_string(n); });
+    static_assert(std::is_same_v<decltype(pull)::value_type, std::string>);
+    check(parses(typed::parse(pull, " 3 blue, 4 red"), 7, std::string("blue=3")), "map spreads the tuple");
+
+    auto whole = typed::map(typed::Int() + typed::Int(), [](const std::tuple<long, long>& t) {
+        return std::get<0>(t) * std::get<1>(t);
+    });
+    check(parses(typed::parse(whole, "6 7"), 3, 42L), "map hands the tuple to a function taking it");
+
+    long seen = 0;
+    auto effect = typed::map(typed::Int(), [&seen](long n) { seen += n; });
+    static_assert(std::is_same_v<decltype(effect)::value_type, std::monostate>);
+    check(typed::parse(effect, "5") && seen == 5, "a void map gives std::monostate and runs once");
+}
+
+struct list_outcome {
+    bool ok;
+    long length;
+    std::size_t count;
+
+    bool operator==(const list_outcome&) const = default;
+};
+
+list_outcome dynamic_list(std::string_view input, std::string_view delimiter, ListEnding ending) {
+    std::size_t count = 0;
+    ox::parser::Int number([&count](void*, long) {
+        ++count;
+        return nullptr;
+    });
+    auto read = delimiter.empty() ? ox::parser::List(std::move(number), ending).parse(nullptr, input)
+                                  : ox::parser::List(delimiter.data(), std::move(number), ending).parse(nullptr, input);
+    return read ? list_outcome{true, read->first, count} : list_outcome{false, 0, 0};
+}
+
+list_outcome typed_list(std::string_view input, std::string_view delimiter, ListEnding ending) {
+    auto read = delimiter.empty() ? typed::parse(typed::List(typed::Int(), ending), input)
+                                  : typed::parse(typed::List(delimiter, typed::Int(), ending), input);
+    return read ? list_outcome{true, long(read->length), read->value} : list_outcome{false, 0, 0};
+}
+
+void list_test() {
+    bool ok = true;
+    for (ListEnding ending : {ListEnding::unended, ListEnding::ended, ListEnding::either})
+        for (std::string_view input : {"", "1", "1,", "1,2,3", "1,2,3,", " 1, 2 ,3", "1,,2", "1,x", ",1", "1,2,"})
+            for (std::string_view delimiter : {",", ""})
+                ok = ok && typed_list(input, delimiter, ending) == dynamic_list(input, delimiter, ending);
+    check(ok, "List agrees with the dynamic List for every ListEnding");
+
+    check(typed_list("1,2,3", ",", ListEnding::unended) == list_outcome{true, 5, 3}, "1,2,3 is three numbers");
+    check(typed_list(" 1 , 2", ",", ListEnding::unended) == list_outcome{true, 5, 2},
+          "the space a number leaves before its comma is not counted, as in the dynamic List");
+    check(!typed_list("1,2,", ",", ListEnding::unended).ok, "an unended list needs a value after the last comma");
+    check(typed_list("1,2,", ",", ListEnding::ended) == list_outcome{true, 4, 2}, "an ended list ends at a comma");
+    check(typed_list("1,2", ",", ListEnding::either).count == 2
+                  && typed_list("1,2,", ",", ListEnding::either).count == 2,
+          "an either list takes both");
+    check(typed_list("1 2 3x", "", ListEnding::unended) == list_outcome{true, 5, 3}, "without delimiter it stops");
+
+    std::vector<long> values;
+    auto collect = typed::List(";", typed::Int(), [&values](long n) { values.push_back(n); });
+    check(typed::parse(collect, "4;5;6") && values == std::vector<long>{4, 5, 6}, "each sees every value in order");
+}
+
+void memo_test() {
+    int calls = 0;
+    auto number = typed::memoize(typed::map(typed::Int(), [&calls](long n) {
+        ++calls;
+        return n * 2;
+    }));
+    // both alternatives start with the same number, so the second one backtracks over it
+    auto grammar = (number + "a"_l) | (number + "b"_l);
+
+    auto plain = typed::parse(grammar, "21 b");
+    check(plain && plain->value == std::tuple{42L, std::string_view("b")} && calls == 2,
+          "without a memo the number is parsed by both alternatives");
+
+    calls = 0;
+    typed::packrat_memo memo;
+    auto replayed = typed::parse(grammar, "21 b", memo);
+    check(replayed && replayed->length == 4 && replayed->value == std::tuple{42L, std::string_view("b")},
+          "the replayed value and length are the parsed ones");
+    check(calls == 1, "with a memo the number is parsed once and replayed");
+
+    calls = 0;
+    auto failed = typed::parse(grammar, "x b", memo);
+    check(!failed && calls == 0, "a failure is replayed too");
+}
+
+void failure_test() {
+    auto color = "red"_l | "green"_l | "blue"_l;
+    auto pull = typed::List(",", typed::Int() + color);
+    auto game = "Game"_l + typed::Int() + ":"_l + typed::List(";", pull);
+
+    std::string_view input = "Game 1: 3 red, 4 blue; 1 green\nGame 2: 2 red, 5 purple";
+    ox::parser::failure_tracker failures;
+    auto read = typed::parse(typed::List("\n", game), input, failures);
+    check(!read && failures.failed(), "a bad color fails the parse");
+    ox::parser::parse_failure report = failures.report(input);
+    check(report.offset == input.find("purple"), "the failure is at the furthest position reached");
+    check(report.expected.size() == 3 && report.expected[0].text == "red" && report.expected[2].text == "blue",
+          "every alternative skipped by the dispatch table is listed");
+    check(report.line_column(input) == std::pair<std::size_t, std::size_t>{2, 18}, "purple is on line 2, column 18");
+    check(report.message(input) == R"(line 2, column 18: expected "red", "green" or "blue", found "purple")",
+          "the message names the expectations and what was found");
+
+    failures.clear();
+    check(!typed::parse(game, "Game x", failures) && failures.report("Game x").expected[0].text == "integer",
+          "an Int reports an integer expectation");
+}
+
+void records_test() {
+    ox::thread_pool<std::function<void()>> pool;
+    auto record = typed::map("Game"_l + typed::Int() + ":"_l + typed::Int(),
+                             [](std::string_view, long id, std::string_view, long count) { return id * 1000 + count; });
+    std::string input;
+    for (int i = 0; i < 997; ++i)
+        input += "Game " + std::to_string(i) + ": " + std::to_string(i % 13) + "\n";
+
+    input.pop_back();
+
+    std::vector<long> sequential;
+    auto read = typed::parse(typed::List("\n", record, [&](long v) { sequential.push_back(v); }), input);
+    check(read && sequential.size() == 997, "the sequential List parses every record");
+    bool ok = true;
+    for (std::size_t chunks : {1, 3, 64, 5000}) {
+        auto parallel = typed::parse_records(record, input, pool, "\n", chunks);
+        ok = ok && parallel && *parallel == sequential;
+    }
+    check(ok, "parse_records gives the sequential List's values in order for any number of chunks");
+
+    // like an unended List, a final delimiter is followed by an empty record, which fails
+    std::string ended = input + "\n";
+    check(!typed::parse(typed::List("\n", record), ended) && !typed::parse_records(record, ended, pool, "\n", 16),
+          "a trailing delimiter fails both");
+    check(!typed::parse_records(record, input + "\nGame x: 1", pool, "\n", 16), "a bad record fails parse_records");
+    auto empty = typed::parse_records(record, "", pool);
+    check(!empty, "an empty input is one empty record, which fails like List does");
+}
+
+void dynamic_or_test() {
+    using namespace ox::parser;
+    // 70 alternatives: the ones past the 64 indexed by the dispatch table are always attempted
+    static std::vector<std::string> names;
+    for (int i = 0; i < 70; ++i)
+        names.push_back("k" + std::to_string(i) + "_");
+    Or keywords = [&]<std::size_t... I>(std::index_sequence<I...>) {
+        return (Or{Literal(names[0].c_str()), Literal(names[1].c_str())} | ... | Literal(names[I + 2].c_str()));
+    }(std::make_index_sequence<68>());
+    bool ok = true;
+    for (const std::string& name : names) {
+        auto read = keywords.parse(nullptr, " " + name);
+        ok = ok && read && read->first == long(name.size() + 1);
+    }
+    check(ok, "every one of 70 alternatives matches");
+
+    failure_scope scope;
+    check(!keywords.parse(nullptr, "x"), "no alternative matches x");
+    check(scope.report("x").expected.size() == 70, "the failure lists all 70 alternatives");
+}
+
+int main() {
+    value_test();
+    or_test();
+    map_test();
+    list_test();
+    memo_test();
+    failure_test();
+    records_test();
+    dynamic_or_test();
+    return report();
+}
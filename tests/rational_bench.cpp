@@ -0,0 +1,106 @@
+#include <ox/math.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <numeric>
+#include <random>
+#include <vector>
+
+/*
+ * Compares ox::rational against eagerly reduced fractions (std::gcd and std::lcm on every operation,
+ * ordering through double), the way ox::rational used to work.
+ * Workloads: summing and multiplying pairs of small fractions, a running sum of 1 / i, and a sort.
+ */
+
+struct eager_rational {
+    long numerator = 0;
+    long denominator = 1;
+
+    eager_rational() = default;
+    eager_rational(long n, long m) : numerator{n}, denominator{m} { reduce(); }
+
+    void reduce() {
+        auto r = std::gcd(numerator, denominator);
+        if (denominator < 0)
+            r = -r;
+        numerator /= r;
+        denominator /= r;
+    }
+
+    eager_rational operator+(const eager_rational& other) const {
+        auto d = std::lcm(denominator, other.denominator);
+        return {numerator * (d / denominator) + other.numerator * (d / other.denominator), d};
+    }
+
+    eager_rational operator*(const eager_rational& other) const {
+        return {numerator * other.numerator, denominator * other.denominator};
+    }
+
+    bool operator<(const eager_rational& other) const {
+        return double(numerator) / double(denominator) < double(other.numerator) / double(other.denominator);
+    }
+};
+
+constexpr int pairs = 1 << 20;
+constexpr int series = 40;
+constexpr int series_repetitions = 20000;
+
+template <typename F>
+long time_ms(F&& f) {
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+}
+
+template <typename R>
+void run(const char* name, const std::vector<std::pair<long, long>>& input) {
+    std::vector<R> values;
+    values.reserve(input.size());
+    for (auto [n, d] : input)
+        values.emplace_back(n, d);
+
+    long checksum = 0;
+    long add = time_ms([&] {
+        for (std::size_t i = 0; i + 1 < values.size(); ++i) {
+            R r = values[i] + values[i + 1];
+            checksum += r.numerator & 1;
+        }
+    });
+    long mul = time_ms([&] {
+        for (std::size_t i = 0; i + 1 < values.size(); ++i) {
+            R r = values[i] * values[i + 1];
+            checksum += r.numerator & 1;
+        }
+    });
+    long harmonic = time_ms([&] {
+        for (int k = 0; k < series_repetitions; ++k) {
+            R sum;
+            for (int i = 1; i <= series; ++i)
+                sum = sum + R(1, i);
+            checksum += sum.numerator & 1;
+        }
+    });
+    long sort = time_ms([&] {
+        std::vector<R> cpy = values;
+        std::sort(cpy.begin(), cpy.end());
+        checksum += cpy.front().numerator & 1;
+    });
+    std::printf("%-16s add %4ld ms  mul %4ld ms  harmonic %4ld ms  sort %4ld ms  (%ld)\n",
+                name, add, mul, harmonic, sort, checksum);
+}
+
+int main() {
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<long> numerator(-100000, 100000);
+    std::uniform_int_distribution<long> denominator(1, 100000);
+    std::vector<std::pair<long, long>> input(pairs);
+    for (auto& [n, d] : input)
+        n = numerator(rng), d = denominator(rng);
+
+    run<eager_rational>("eager", input);
+    run<ox::rational>("ox::rational", input);
+#ifdef __SIZEOF_INT128__
+    run<ox::rational128>("ox::rational128", input);
+#endif
+}
@@ -0,0 +1,172 @@
+#include <ox/parser.h>
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include "check.h"
+
+/*
+ * Checks the ox::parser::scan kernels against the scalar code the parser nodes used before them, on edge cases and
+ * on random inputs. The inputs are long enough that every vector step and every scalar tail is taken, and matches
+ * are placed on both sides of the 16 and 32 byte block boundaries.
+ */
+
+namespace scan = ox::parser::scan;
+
+namespace scalar {
+    bool space(char c) { return std::isspace((unsigned char)c); }
+
+    std::size_t skip_whitespace(std::string_view s) {
+        return std::size_t(std::ranges::find_if_not(s, space) - s.begin());
+    }
+
+    std::size_t find_whitespace(std::string_view s) { return std::size_t(std::ranges::find_if(s, space) - s.begin()); }
+
+    std::size_t find(std::string_view s, std::string_view needle, std::size_t from) {
+        std::size_t found = s.find(needle, from);
+        return found == std::string_view::npos ? s.size() : found;
+    }
+
+    // String: up to the first whitespace or the first occurrence of the delimiter
+    std::size_t find_word_end(std::string_view s, std::string_view delimiter) {
+        auto tail = std::ranges::find_if(s, space);
+        if (!delimiter.empty())
+            tail = std::min(tail, std::search(s.begin(), s.end(), delimiter.begin(), delimiter.end()));
+        return std::size_t(tail - s.begin());
+    }
+
+    // Literal: the first occurrence, preceded by whitespace only
+    std::size_t match_literal(std::string_view s, std::string_view literal) {
+        std::size_t index = s.find(literal);
+        if (index == std::string_view::npos || !std::all_of(s.begin(), s.begin() + long(index), space))
+            return std::string_view::npos;
+        return index + literal.size();
+    }
+
+    // Int: std::from_chars
+    template <typename T>
+    std::size_t parse_int(std::string_view s, T& value) {
+        auto [end, error] = std::from_chars(s.data(), s.data() + s.size(), value);
+        return error == std::errc{} ? std::size_t(end - s.data()) : 0;
+    }
+} // namespace scalar
+
+template <typename T>
+bool same_int(std::string_view s) {
+    T fast = 0, slow = 0;
+    std::size_t fast_length = scan::parse_int(s, fast);
+    std::size_t slow_length = scalar::parse_int(s, slow);
+    return fast_length == slow_length && (fast_length == 0 || fast == slow);
+}
+
+bool same_ints(std::string_view s) {
+    return same_int<long>(s) && same_int<unsigned long>(s) && same_int<int>(s) && same_int<unsigned>(s)
+           && same_int<std::int16_t>(s) && same_int<std::uint8_t>(s);
+}
+
+bool same_scans(std::string_view s, std::string_view needle) {
+    bool ok = scan::skip_whitespace(s) == scalar::skip_whitespace(s)
+              && scan::find_whitespace(s) == scalar::find_whitespace(s)
+              && scan::find_word_end(s, needle) == scalar::find_word_end(s, needle)
+              && scan::match_literal(s, needle) == scalar::match_literal(s, needle);
+    for (std::size_t from = 0; from <= s.size(); from += 7)
+        ok = ok && scan::find(s, needle, from) == scalar::find(s, needle, from);
+    return ok;
+}
+
+void int_test() {
+    for (std::string_view s : {"", "-", "--1", "-x", "+1", " 1", "0", "-0", "007", "x12", "12x", "1-2"})
+        check(same_ints(s), "integer edge cases match from_chars");
+    for (std::string_view s : {"127", "128", "-128", "-129", "255", "256", "32767", "32768", "-32768", "-32769",
+                               "2147483647", "2147483648", "-2147483648", "-2147483649", "4294967295", "4294967296"})
+        check(same_ints(s), "8, 16 and 32 bit limits match from_chars");
+    for (std::string_view s : {"9223372036854775807", "9223372036854775808", "-9223372036854775808",
+                               "-9223372036854775809", "18446744073709551615", "18446744073709551616",
+                               "1234567890123456789", "-1234567890123456789", "99999999999999999999999"})
+        check(same_ints(s), "19 digit and longer values match from_chars");
+
+    // every length around the 8 digit chunks and the 16 and 18 digit cutovers, with and without a tail
+    std::string digits = "98765432109876543210987";
+    bool ok = true;
+    for (std::size_t n = 1; n <= digits.size(); ++n)
+        for (std::string_view tail : {"", " ", "a", ":", "/"})
+            for (std::string_view sign : {"", "-"}) {
+                std::string s = std::string(sign) + digits.substr(0, n) + std::string(tail);
+                ok = ok && same_ints(s);
+                std::string zeros = std::string(sign) + std::string(n, '0') + "1" + std::string(tail);
+                ok = ok && same_ints(zeros);
+            }
+    check(ok, "every digit count matches from_chars");
+
+    // bytes next to '0' and '9' must stop the SWAR chunk ('/' and ':' are the neighbours of the digits)
+    ok = true;
+    for (std::size_t at = 0; at < 8; ++at)
+        for (char c : {'/', ':', '\0', char(0x80), char(0xB0), char(0xFF), ' ', 'a', 'p'}) {
+            std::string s = "1234567812345678";
+            s[at] = c;
+            ok = ok && same_ints(s);
+            s[at + 8] = c;
+            ok = ok && same_ints(s);
+        }
+    check(ok, "a non digit anywhere in a chunk ends the number where from_chars does");
+
+    std::mt19937 gen(7);
+    std::uniform_int_distribution<int> length(0, 24), pick(0, 13);
+    ok = true;
+    for (int i = 0; i < 200000 && ok; ++i) {
+        std::string s;
+        for (int n = length(gen); n > 0; --n) {
+            int p = pick(gen);
+            s += p < 10 ? char('0' + p) : "-x 9"[p - 10];
+        }
+        ok = same_ints(s);
+    }
+    check(ok, "random digit strings match from_chars");
+}
+
+void scan_test() {
+    for (std::string_view s : {"", " ", "\t\n\v\f\r ", "a", " a", "a b"})
+        for (std::string_view needle : {"", "a", " a", "ab", ", "})
+            check(same_scans(s, needle), "scan edge cases match the scalar code");
+
+    // the needle, a whitespace byte and a lone first byte at every offset around the block boundaries
+    bool ok = true;
+    for (std::string_view needle : {";", "; ", ", ", "::", "abc", "-->", "\n\n", "long delimiter"})
+        for (std::size_t at = 0; at < 72; ++at) {
+            std::string s(80, 'x');
+            s.replace(at, std::min(needle.size(), s.size() - at), needle.substr(0, s.size() - at));
+            ok = ok && same_scans(s, needle);
+            std::string lead(at, ' ');
+            ok = ok && same_scans(lead + std::string(needle) + "tail", needle);
+            std::string partial(80, 'y');
+            partial[at] = needle.front();
+            ok = ok && same_scans(partial + std::string(needle), needle);
+            std::string spaced(80, 'z');
+            spaced[at] = "\t\n\v\f\r "[at % 6];
+            ok = ok && same_scans(spaced, needle);
+        }
+    check(ok, "matches on either side of the 16 and 32 byte boundaries agree with the scalar code");
+
+    std::mt19937 gen(11);
+    std::uniform_int_distribution<int> length(0, 100), pick(0, 7);
+    const char alphabet[] = "ab; \t\n,:";
+    ok = true;
+    for (int i = 0; i < 100000 && ok; ++i) {
+        std::string s, needle;
+        for (int n = length(gen); n > 0; --n)
+            s += alphabet[pick(gen)];
+        for (int n = length(gen) % 4; n > 0; --n)
+            needle += alphabet[pick(gen)];
+        ok = same_scans(s, needle);
+    }
+    check(ok, "random inputs agree with the scalar code");
+}
+
+int main() {
+    int_test();
+    scan_test();
+    return report();
+}
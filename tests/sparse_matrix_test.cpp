@@ -0,0 +1,135 @@
+#include <ox/matrix.h>
+#include <ox/threading.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "check.h"
+
+/*
+ * Checks ox::sparse_matrix: building the CSR arrays from coordinates and from a dense matrix, element access and
+ * transposition, and sparse times vector and sparse times dense products, sequential and on a thread_pool, against
+ * the same products on the dense matrix.
+ */
+
+template <typename A, typename B>
+bool same(const A& a, const B& b) {
+    return std::equal(std::begin(a), std::end(a), std::begin(b), std::end(b));
+}
+
+bool near(const std::vector<double>& a, const std::vector<double>& b) {
+    if (a.size() != b.size())
+        return false;
+    for (std::size_t i = 0; i < a.size(); ++i)
+        if (std::abs(a[i] - b[i]) > 1e-9)
+            return false;
+    return true;
+}
+
+bool near(const ox::matrix<double>& a, const ox::matrix<double>& b) {
+    if (a.get_width() != b.get_width() || a.get_height() != b.get_height())
+        return false;
+    for (std::size_t i = 0; i < std::size_t(a.get_width() * a.get_height()); ++i)
+        if (std::abs(a.element(i) - b.element(i)) > 1e-9)
+            return false;
+    return true;
+}
+
+// height x width with roughly one element in density non-zero
+ox::matrix<double> random_sparse(std::size_t width, std::size_t height, int density, unsigned seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    std::uniform_int_distribution<int> pick(0, density - 1);
+    std::vector<double> values(width * height, 0.0);
+    for (double& v : values)
+        if (pick(gen) == 0)
+            v = dist(gen);
+    return ox::matrix<double>(long(width), std::move(values));
+}
+
+std::vector<double> column(const ox::matrix<double>& m) {
+    return std::vector<double>(m.get_raw().begin(), m.get_raw().end());
+}
+
+void construction_test() {
+    // [[1 0 2 0]
+    //  [0 0 0 0]
+    //  [0 3 0 4]]
+    ox::coo_matrix<long> coo(4, 3);
+    coo.add(3, 2, 4);
+    coo.add(0, 0, 1);
+    coo.add(1, 2, 1);
+    coo.add(2, 0, 2);
+    coo.add(1, 2, 2);
+    coo.add(3, 1, 5);
+    coo.add(3, 1, -5);
+    ox::sparse_matrix<long> s(coo);
+    check(s.get_width() == 4 && s.get_height() == 3, "the sparse matrix is 4 x 3");
+    check(s.non_zeros() == 4, "duplicates are summed and zeros dropped");
+    check(same(s.get_row_offsets(), std::vector<std::size_t>{0, 2, 2, 4}), "row offsets are 0 2 2 4");
+    check(same(s.get_columns(), std::vector<std::size_t>{0, 2, 1, 3}), "columns are sorted within each row");
+    check(same(s.get_values(), std::vector<long>{1, 2, 3, 4}), "values are 1 2 3 4");
+    check(s.at(1, 2) == 3 && s.at(3, 1) == 0 && s.at(2, 0) == 2, "at reads stored elements and zeros");
+
+    ox::matrix<long> dense(4, {1, 0, 2, 0, 0, 0, 0, 0, 0, 3, 0, 4});
+    check(s.to_dense() == dense, "to_dense gives back the dense matrix");
+    ox::sparse_matrix<long> from_dense(dense);
+    check(same(from_dense.get_row_offsets(), s.get_row_offsets()) && same(from_dense.get_columns(), s.get_columns())
+                  && same(from_dense.get_values(), s.get_values()),
+          "built from the dense matrix, the CSR arrays are the same");
+
+    ox::sparse_matrix<long> t = s.transposed();
+    check(t.get_width() == 3 && t.get_height() == 4, "the transpose is 3 x 4");
+    check(t.to_dense() == dense.transpose(), "transposed matches the dense transpose");
+    check(same(t.get_columns(), std::vector<std::size_t>{0, 2, 0, 2}), "the transpose keeps columns sorted");
+
+    check(throws<std::out_of_range>([&] { coo.add(4, 0, 1); }), "adding outside the matrix throws");
+    check(throws<std::out_of_range>([&] { (void) s.at(0, 3); }), "at outside the matrix throws");
+}
+
+void product_test() {
+    ox::thread_pool<std::function<void()>> pool;
+    ox::matrix<double> dense = random_sparse(300, 500, 20, 3);
+    ox::sparse_matrix<double> s(dense);
+    check(s.to_dense() == dense, "a random sparse matrix round trips");
+
+    std::vector<double> x(300);
+    for (std::size_t i = 0; i < x.size(); ++i)
+        x[i] = double(i % 7) - 3.0;
+    std::vector<double> expected = column(ox::matrix<double>(dense * ox::matrix<double>(1, std::vector<double>(x))));
+    check(near(s * x, expected), "SpMV matches the dense product");
+    std::vector<double> y(500, 42.0);
+    s.multiply(x, y, pool);
+    check(near(y, expected), "SpMV on the pool matches the dense product and overwrites y");
+
+    ox::matrix<double> b = random_sparse(7, 300, 1, 4);
+    ox::matrix<double> product(dense * b);
+    check(near(s * b, product), "sparse times dense matches the dense product");
+    check(near(s.multiply(b, pool), product), "sparse times dense on the pool matches the dense product");
+
+    // from inside a task of the pool it runs on
+    bool nested = false;
+    std::atomic_bool done = false;
+    pool.submit([&] {
+        nested = near(s.multiply(b, pool), product);
+        done = true;
+        done.notify_one();
+    });
+    done.wait(false);
+    check(nested, "sparse times dense from inside a pool task");
+
+    check(throws<std::invalid_argument>([&] { (void) (s * std::vector<double>(299)); }),
+          "a vector of the wrong size throws");
+    check(throws<ox::invalid_matrix_dimensions>(
+                  [&] { (void) s.multiply(ox::matrix<double>(7, std::vector<double>(7 * 299))); }),
+          "a dense matrix of the wrong height throws");
+}
+
+int main() {
+    construction_test();
+    product_test();
+    return report();
+}